@@ -1,8 +1,14 @@
 
 from sys import argv
+import os
+import sys
 import subprocess
 import json
 
+# result_cache.py is at the root of the repository, where this file is copied in the image
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from result_cache import ResultCache
+
 # If unable to parse output file argument
 OUTPUT_FILE_PATH = '/output/error.json'
 
@@ -17,7 +23,10 @@ def main(num_compute_nodes, job_trace_file, max_sys_jobs, workflow_specification
     cmd = ["/simulator/task_clustering_batch_simulator/simulator", num_compute_nodes, job_trace_file, max_sys_jobs, workflow_specification, start_time, algorithm, batch_algorithm, wrench_log, output_file]
     try:
         # Timeout throws an exception
-        res = subprocess.check_output(cmd, timeout=3600, stderr=subprocess.STDOUT)
+        # Scenarios that were already simulated aren't run again (the store is kept next to the results, which
+        # outlive the container)
+        result_cache = ResultCache(os.path.join(os.path.dirname(os.path.abspath(output_file)), '.result_cache'))
+        res, cached = result_cache.run(cmd, timeout=3600, output_file=output_file, stderr=subprocess.STDOUT)
         # res captures all stdout and stderr, but we don't need it
         # cpp simulator writes out json by itself if success
     except Exception as e:
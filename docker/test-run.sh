@@ -11,3 +11,7 @@ sudo docker run -v $PWD:/output wrenchproject/task-clustering:latest 100 /simula
 sudo docker run -v $PWD:/output wrenchproject/task-clustering:latest 100 /simulator/trace_files/kth_sp2.json 100 dax:/simulator/workflows/CYBERSHAKE_250_3600000.dax 104400 zhang:noglobal:nobsearch:prediction conservative_bf --wrench-no-log /output/test.json
 
 sudo docker run -v $PWD:/output wrenchproject/task-clustering:latest python3 -u simulator.py 100 /simulator/trace_files/kth_sp2.json 100 dax:/simulator/workflows/CYBERSHAKE_250_3600000.dax 104400 zhang:noglobal:nobsearch:prediction conservative_bf --wrench-no-log /output/test.json
+
+# Re-planning: the trace's jobs finish well before their requested times, so queue waits come in shorter than
+# conservative_bf predicts and the dfjs clusters shrink, down to the longest task of the re-clustered levels
+sudo docker run -v $PWD:/output wrenchproject/task-clustering:latest 100 /simulator/trace_files/kth_sp2.json 10 dax:/simulator/workflows/CYBERSHAKE_50_360000.dax 86400 static:dfjs-vnone-3600-1 conservative_bf --replan-margin=0.1 --wrench-no-log /output/replan.json
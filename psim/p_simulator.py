@@ -6,13 +6,19 @@ from datetime import datetime
 from threading import Thread
 from threading import Lock
 
+import os
 import sys
 import json
 
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from result_cache import ResultCache
+
 lock = Lock()
 save_to_mongo = False
 coll_name = 'default_coll'
 commands = []
+# Scenarios that were already simulated aren't run again
+result_cache = ResultCache()
 
 def simulator_command():
     executable = '../build/simulator'
@@ -81,8 +87,9 @@ def run_simulator(command):
     end = start
     try:
         # Timeout throws exception, this is okay i guess
-        res = subprocess.check_output(command, timeout=3600, stderr=subprocess.STDOUT)
+        res, cached = result_cache.run(command, timeout=3600, stderr=subprocess.STDOUT)
         end = time.time()
+        obj['cached'] = cached
         res = print_process_output(command, res, end - start)
         obj['success'] = True
         if "zhang" in command[6]:
@@ -0,0 +1,169 @@
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import tempfile
+from threading import Lock
+
+# Local store of simulation results, keyed by a hash of everything that determines them: the simulator's
+# arguments, the contents of the files they name (job trace, workflow, plan), and the simulator binary itself
+# along with the shared libraries it is linked against. A plan the simulator exports is stored with its results.
+# Entries are single json files written atomically, so several threads or processes can share a store.
+
+DEFAULT_CACHE_DIR = os.environ.get('SIMULATOR_RESULT_CACHE',
+                                   os.path.join(os.path.expanduser('~'), '.cache', 'simulator_results'))
+
+# Content hashes of the files seen so far, keyed by (path, size, modification time)
+file_hashes = {}
+file_hashes_lock = Lock()
+
+
+def hash_file(path):
+    stat = os.stat(path)
+    memo_key = (os.path.abspath(path), stat.st_size, stat.st_mtime)
+    with file_hashes_lock:
+        if memo_key in file_hashes:
+            return file_hashes[memo_key]
+    sha = hashlib.sha256()
+    with open(path, 'rb') as f:
+        for block in iter(lambda: f.read(1 << 20), b''):
+            sha.update(block)
+    digest = sha.hexdigest()
+    with file_hashes_lock:
+        file_hashes[memo_key] = digest
+    return digest
+
+
+# Paths of the shared libraries an executable is dynamically linked against (e.g., libwrench and SimGrid), which
+# determine the results as much as the executable itself, keyed by (path, size, modification time) of the executable
+linked_libraries = {}
+
+
+def get_linked_libraries(executable):
+    stat = os.stat(executable)
+    memo_key = (os.path.abspath(executable), stat.st_size, stat.st_mtime)
+    with file_hashes_lock:
+        if memo_key in linked_libraries:
+            return linked_libraries[memo_key]
+    libraries = []
+    try:
+        # Lines such as "libwrench.so => /usr/local/lib/libwrench.so (0x...)" or "/lib64/ld-linux-x86-64.so.2 (0x...)"
+        output = subprocess.check_output(['ldd', executable], stderr=subprocess.DEVNULL).decode('utf-8')
+        for line in output.splitlines():
+            fields = line.split('=>')[-1].split()
+            if fields and os.path.isfile(fields[0]):
+                libraries.append(os.path.realpath(fields[0]))
+    except (OSError, subprocess.CalledProcessError):
+        pass
+    libraries = sorted(set(libraries))
+    with file_hashes_lock:
+        linked_libraries[memo_key] = libraries
+    return libraries
+
+
+# The option through which the simulator writes the static clustering plan it computed to a file, which is an
+# output of the run rather than an input
+EXPORT_PLAN_OPTION = '--export-plan='
+
+
+# The input file an argument names, if any: the argument itself, the value of an option such as
+# --opt=/path/to/file, a plan to load in static:plan-/path/to/plan.json, or what follows the type in a
+# workflow specification such as dax:/path/to/file.dax
+def named_file(argument):
+    if argument.startswith('--'):
+        if argument.startswith(EXPORT_PLAN_OPTION) or ('=' not in argument):
+            return None
+        path = argument.split('=', 1)[1]
+    elif argument.startswith('static:plan-'):
+        path = argument[len('static:plan-'):]
+    elif os.path.isfile(argument):
+        path = argument
+    elif ':' in argument:
+        path = argument.split(':', 1)[1]
+    else:
+        return None
+    return path if os.path.isfile(path) else None
+
+
+# The file to which the simulator exports its plan, if any
+def exported_plan_file(command):
+    for argument in [str(a) for a in command[1:]]:
+        if argument.startswith(EXPORT_PLAN_OPTION):
+            return argument[len(EXPORT_PLAN_OPTION):]
+    return None
+
+
+class ResultCache:
+
+    def __init__(self, directory=DEFAULT_CACHE_DIR):
+        self.directory = directory
+        os.makedirs(self.directory, exist_ok=True)
+
+    # output_file: the argument that only says where to write the json results, which doesn't
+    # change them and so isn't part of the key
+    def key(self, command, output_file=None):
+        executable = shutil.which(command[0]) or command[0]
+        inputs = {'binary': hash_file(executable), 'arguments': [], 'files': {},
+                  'libraries': {library: hash_file(library) for library in get_linked_libraries(executable)}}
+        for argument in [str(a) for a in command[1:]]:
+            if (output_file is not None) and (argument == output_file):
+                continue
+            inputs['arguments'].append(argument)
+            path = named_file(argument)
+            if path is not None:
+                inputs['files'][argument] = hash_file(path)
+        return hashlib.sha256(json.dumps(inputs, sort_keys=True).encode('utf-8')).hexdigest()
+
+    def path(self, key):
+        return os.path.join(self.directory, key[:2], key + '.json')
+
+    def get(self, key):
+        try:
+            with open(self.path(key), 'r') as f:
+                return json.load(f)
+        except (IOError, ValueError):
+            return None
+
+    def put(self, key, entry):
+        path = self.path(key)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        fd, tmp_path = tempfile.mkstemp(dir=os.path.dirname(path))
+        with os.fdopen(fd, 'w') as f:
+            json.dump(entry, f)
+        os.replace(tmp_path, path)
+
+    # Run the simulator unless its results are in the store, in which case its output is replayed (and
+    # its json results written to output_file, if any, and its plan to the --export-plan file, if any).
+    # Failed runs aren't stored, nor runs that didn't write the plan they were asked to export.
+    # Returns the output (bytes) and whether it came from the store.
+    def run(self, command, timeout, output_file=None, stderr=None):
+        key = self.key(command, output_file)
+        plan_file = exported_plan_file(command)
+        entry = self.get(key)
+        if entry is not None:
+            if (output_file is not None) and (entry.get('json') is not None):
+                with open(output_file, 'w') as f:
+                    json.dump(entry['json'], f)
+            if plan_file is not None:
+                with open(plan_file, 'w') as f:
+                    f.write(entry['plan'])
+            return entry['output'].encode('utf-8'), True
+
+        res = subprocess.check_output(command, timeout=timeout, stderr=stderr)
+
+        entry = {'command': command, 'output': res.decode('utf-8'), 'json': None}
+        if (output_file is not None) and os.path.isfile(output_file):
+            try:
+                with open(output_file, 'r') as f:
+                    entry['json'] = json.load(f)
+            except ValueError:
+                pass
+        if plan_file is not None:
+            try:
+                with open(plan_file, 'r') as f:
+                    entry['plan'] = f.read()
+            except IOError:
+                return res, False
+        self.put(key, entry)
+        return res, False
@@ -3,6 +3,10 @@ import time
 import random
 import pymongo
 import urllib.parse
+from result_cache import ResultCache
+
+# Scenarios that were already simulated aren't run again
+result_cache = ResultCache()
 
 # TODO - swap out hardcoded valued for command[]
 # TODO - maybe don't vary the random seed
@@ -95,8 +99,10 @@ def run_simulator(command):
     end = start
     try:
         # Timeout throws exception, this is okay i guess
-        res = subprocess.check_output(command, timeout=900)
+        res, cached = result_cache.run(command, timeout=900)
         end = time.time()
+        if cached:
+            print("(results from the cache)")
         res = print_process_output(res, end - start)
         obj['success'] = True
         obj['makespan'] = float((res[len(res) - 6]).split("=")[1])
@@ -11,6 +11,70 @@ namespace wrench {
     public:
         static nlohmann::json sim_json;
 
+        // Number of threads used to compute makespan estimates (--threads=n)
+        static unsigned long num_threads;
+
+        // CPU time allotted to each grouping decision, in seconds, 0 for no limit (--grouping-budget=seconds)
+        static double grouping_budget;
+
+        // Coefficient of variation of task runtimes, for tasks that don't specify one (--runtime-cv=cv)
+        static double runtime_cv;
+
+        // Seed used to sample task runtimes (--runtime-seed=s)
+        static unsigned long runtime_seed;
+
+        // Target probability that a job expires, used instead of EXECUTION_TIME_FUDGE_FACTOR if
+        // non-zero (--expiration-probability=p)
+        static double expiration_probability;
+
+        // Whether the (finish time, node-seconds) Pareto front of each number-of-nodes decision is added to the
+        // output (--pareto-front)
+        static bool export_pareto_fronts;
+
+        // Weight of the finish time when picking numbers of nodes from Pareto fronts, -1 to just pick the
+        // earliest finish time (--pareto-weight=w)
+        static double pareto_weight;
+
+        // Whether running pilot jobs run ready tasks of the next group on their idle hosts (--work-stealing)
+        static bool work_stealing;
+
+        // Maximum number of staggered jobs a job of independent tasks is split into, 1 for no split
+        // (--staggered-jobs=n)
+        static unsigned long max_staggered_jobs;
+
+        // Maximum number of single-node, single-task jobs submitted as one job array, which counts as one job in
+        // the system, 1 for no arrays (--job-arrays=n)
+        static unsigned long max_job_array_size;
+
+        // Relative difference between an observed queue wait and its prediction beyond which static clustering
+        // re-plans the jobs that haven't been submitted, 0 for never (--replan-margin=m)
+        static double replan_margin;
+
+        // Bandwidth at which each batch job stages its input files in and its output files out, in bytes per
+        // second, 0 to not model staging (--staging-bandwidth=MBps)
+        static double staging_bandwidth;
+
+        // Whether static clustering submits, as pilot jobs, jobs whose parents are running but whose predicted queue
+        // wait exceeds the parents' remaining runtime (--static-lookahead)
+        static bool static_lookahead;
+
+        // File to which static clustering writes the jobs it computed, for static:plan-file to load them in
+        // later runs, empty for none (--export-plan=file)
+        static std::string plan_file;
+
+        // Makespan estimates, wait time estimates, and splits that were skipped because a lower bound
+        // showed that they couldn't be chosen
+        static unsigned long num_pruned_makespan_estimates;
+        static unsigned long num_pruned_wait_time_estimates;
+        static unsigned long num_pruned_splits;
+
+        // Events processed along with an earlier event, before the WMS acted on them (Zhang and Glume)
+        static unsigned long num_coalesced_events;
+
+        // Job arrays submitted, and their total number of elements
+        static unsigned long num_job_arrays;
+        static unsigned long num_job_array_elements;
+
     };
 };
 
@@ -18,14 +18,18 @@ namespace wrench {
     static int sequence = 0;
 
     GlumeWMS::GlumeWMS(Simulator *simulator, std::string hostname, double waste_bound,
-                                         double beat_bound, std::shared_ptr<BatchComputeService> batch_service) :
+                                         double beat_bound, bool multiway,
+                                         std::shared_ptr<BatchComputeService> batch_service) :
             WMS(nullptr, nullptr, {batch_service}, {}, {}, nullptr, hostname, "clustering_wms") {
         this->simulator = simulator;
         this->waste_bound = waste_bound;
         this->beat_bound = beat_bound;
+        this->multiway = multiway;
         this->batch_service = batch_service;
         this->pending_placeholder_job = nullptr;
         this->number_of_splits = 0;
+        this->budget = new DecisionBudget(Globals::grouping_budget);
+        this->previous_num_levels = 0;
     }
 
     int GlumeWMS::main() {
@@ -39,11 +43,29 @@ namespace wrench {
         this->job_manager = this->createJobManager();
         this->proxyWMS = new ProxyWMS(this->getWorkflow(), this->job_manager, this->batch_service);
 
+        for (unsigned long i = 0; i < this->getWorkflow()->getNumLevels(); i++) {
+            std::vector<WorkflowTask *> tasks_in_level = this->getWorkflow()->getTasksInTopLevelRange(i, i);
+            this->level_num_tasks.push_back(tasks_in_level.size());
+            this->level_sequential_times.push_back(WorkflowUtil::estimateMakespan(tasks_in_level, 1, this->core_speed));
+        }
+
         Globals::sim_json["end_levels"] = std::vector<unsigned long> ();
+        Globals::sim_json["budget_truncated"] = std::vector<bool> ();
+        if (this->multiway) {
+            Globals::sim_json["group_estimates"] = std::vector<unsigned long> ();
+        }
+        if (Globals::export_pareto_fronts) {
+            Globals::sim_json["pareto_fronts"] = nlohmann::json::array();
+        }
 
         while (not this->getWorkflow()->isDone()) {
             applyGroupingHeuristic();
             this->waitForAndProcessNextEvent();
+            // Process all the events that happened at the same date before acting on them
+            while (this->waitForAndProcessNextEvent(EVENT_COALESCING_TIMEOUT)) {
+                Globals::num_coalesced_events++;
+            }
+            dispatchAllReadyTasks();
         }
 
         WRENCH_INFO("#SPLITS= %lu", this->number_of_splits);
@@ -71,6 +93,14 @@ namespace wrench {
 
         unsigned long num_levels = end_level + 1;
 
+        // Queue wait time predictions only hold for the current state of the batch queue
+        this->wait_time_estimates.clear();
+        this->partition_estimates.clear();
+        this->group_estimates.clear();
+        this->pareto_fronts.clear();
+
+        this->budget->restart();
+
         double parent_runtime = this->proxyWMS->findMaxDuration(this->running_placeholder_jobs);
 
         WRENCH_INFO("Parent job runtime: %lf", parent_runtime);
@@ -93,8 +123,7 @@ namespace wrench {
         // Adjust the run and wait times for leeway
         if (best_leeway_entire_dag > 0) {
             requested_execution_time += best_leeway_entire_dag;
-            estimated_wait_time = this->proxyWMS->estimateWaitTime(requested_parallelism, requested_execution_time,
-                                                        this->simulation->getCurrentSimulatedDate(), &sequence);
+            estimated_wait_time = this->estimateWaitTime(requested_parallelism, requested_execution_time);
             WRENCH_INFO("entire dag recalculated wait_time: %lf",estimated_wait_time);
             WRENCH_INFO("entire dag recalculated runtime: %lf", requested_execution_time);
         }
@@ -106,87 +135,171 @@ namespace wrench {
 
         unsigned long partial_dag_end_level = end_level;
 
-        // Find the best split
-        for (unsigned long i = start_level; i < num_levels - 1; i++) {
-            WRENCH_INFO("Candidate end level: %lu", i);
+        // Candidate end levels for the first group, around the previous decision's group size first if time is limited
+        std::vector<unsigned long> candidate_end_levels;
+        if (this->budget->isLimited() and (start_level < end_level)) {
+            candidate_end_levels = DecisionBudget::promiseOrder(start_level, end_level - 1,
+                                                                start_level + this->previous_num_levels - 1);
+        } else if (not this->budget->isLimited()) {
+            for (unsigned long i = start_level; i < num_levels - 1; i++) {
+                candidate_end_levels.push_back(i);
+            }
+        }
 
-            std::tuple<double, double, unsigned long> start_to_split = estimateJob(start_level, i, parent_runtime);
-            double wait_one = std::get<0>(start_to_split);
-            double run_one = std::get<1>(start_to_split);
-            unsigned long nodes_one = std::get<2>(start_to_split);
+        if (this->multiway) {
+            // Find the best partition into any number of groups, of which only the first one is submitted now
+            double best_split_makespan = DBL_MAX;
+            unsigned long best_split_end_level = end_level;
+            std::tuple<double, double, unsigned long> best_first_group;
 
-            WRENCH_INFO("1: num nodes: %lu", std::get<2>(start_to_split));
-            WRENCH_INFO("1: wait_time: %lf", wait_one);
-            WRENCH_INFO("1: runtime: %lf", run_one);
+            for (auto i : candidate_end_levels) {
+                if (this->budget->isExhausted()) {
+                    break;
+                }
+                // Each group runs after the previous one started
+                double bound = getRuntimeLowerBound(start_level, i, findMaxParallelism(start_level, i)) +
+                               getRuntimeLowerBound(i + 1, end_level, findMaxParallelism(i + 1, end_level));
+                if (bound >= best_split_makespan) {
+                    Globals::num_pruned_splits++;
+                    continue;
+                }
+                std::tuple<double, double, unsigned long> first_group = estimateJobWithLeeway(start_level, i,
+                                                                                              parent_runtime);
+                if (std::get<0>(first_group) == DBL_MAX) {
+                    continue;
+                }
+                double rest = std::get<0>(findBestPartition(i + 1, end_level, start_level,
+                                                            std::get<1>(first_group)));
+                if (rest == DBL_MAX) {
+                    continue;
+                }
+                double makespan = std::get<0>(first_group) + rest;
+                if (makespan < best_split_makespan) {
+                    best_split_makespan = makespan;
+                    best_split_end_level = i;
+                    best_first_group = first_group;
+                }
+            }
 
-            // Calculate leeway needed for first group vs. currently running parent
-            double max_leeway_one = std::max<double>(0, (parent_runtime - wait_one));
-            double best_leeway_one = calculateLeewayBinarySearch(run_one, nodes_one, parent_runtime, 0, max_leeway_one);
+            std::cout << "best partition makespan: " << best_split_makespan << std::endl;
+            WRENCH_INFO("Estimated %lu groups of levels for %lu levels", this->group_estimates.size(),
+                        end_level - start_level + 1);
+            Globals::sim_json["group_estimates"].push_back(this->group_estimates.size());
+
+            if ((best_split_end_level < end_level) and
+                (best_split_makespan + (best_split_makespan * beat_bound) < best_makespan)) {
+                partial_dag_end_level = best_split_end_level;
+                best_makespan = best_split_makespan;
+                estimated_wait_time = std::get<0>(best_first_group);
+                requested_execution_time = std::get<1>(best_first_group);
+                requested_parallelism = std::get<2>(best_first_group);
+
+                std::cout << "Planned groups: " << start_level << "-" << partial_dag_end_level;
+                double runtime = requested_execution_time;
+                unsigned long previous_start_level = start_level;
+                for (unsigned long l = partial_dag_end_level + 1; l <= end_level;) {
+                    unsigned long group_end_level = std::get<1>(findBestPartition(l, end_level, previous_start_level,
+                                                                                  runtime));
+                    runtime = std::get<1>(estimateGroup(l, group_end_level));
+                    std::cout << " " << l << "-" << group_end_level;
+                    previous_start_level = l;
+                    l = group_end_level + 1;
+                }
+                std::cout << std::endl;
+            }
+        } else {
+            // Find the best split
+            for (auto i : candidate_end_levels) {
+                if (this->budget->isExhausted()) {
+                    break;
+                }
 
-            std::cout << "1: leeway needed: " << best_leeway_one << std::endl;
+                WRENCH_INFO("Candidate end level: %lu", i);
 
-            if (best_leeway_one > (run_one * .1)) {
-                std::cout << "Too much leeway needed - skipping group\n";
-                continue;
-            }
+                // The second group runs after the first one started
+                double bound = getRuntimeLowerBound(start_level, i, findMaxParallelism(start_level, i)) +
+                               getRuntimeLowerBound(i + 1, end_level, findMaxParallelism(i + 1, end_level));
+                if (bound >= best_makespan) {
+                    Globals::num_pruned_splits++;
+                    continue;
+                }
 
-            // Adjust the run and wait times for leeway
-            if (best_leeway_one > 0) {
-                run_one += best_leeway_one;
-                wait_one = this->proxyWMS->estimateWaitTime(nodes_one, run_one,
-                                                            this->simulation->getCurrentSimulatedDate(), &sequence);
-                std::cout << "1: recalculated wait_time: " << wait_one << std::endl;
-                std::cout << "1: recalculated runtime: " << run_one << std::endl;
-            }
+                std::tuple<double, double, unsigned long> start_to_split = estimateJob(start_level, i, parent_runtime);
+                double wait_one = std::get<0>(start_to_split);
+                double run_one = std::get<1>(start_to_split);
+                unsigned long nodes_one = std::get<2>(start_to_split);
 
-            std::tuple<double, double, unsigned long> rest = estimateJob(i + 1, end_level, run_one);
-            double wait_two = std::get<0>(rest);
-            double run_two = std::get<1>(rest);
-            unsigned long nodes_two = std::get<2>(rest);
+                WRENCH_INFO("1: num nodes: %lu", std::get<2>(start_to_split));
+                WRENCH_INFO("1: wait_time: %lf", wait_one);
+                WRENCH_INFO("1: runtime: %lf", run_one);
 
-            std::cout << "2: num nodes: " << nodes_two << std::endl;
-            std::cout << "2: wait_time: " << wait_two << std::endl;
-            std::cout << "2: runtime: " << run_two << std::endl;
+                // Calculate leeway needed for first group vs. currently running parent
+                double max_leeway_one = std::max<double>(0, (parent_runtime - wait_one));
+                double best_leeway_one = calculateLeewayBinarySearch(run_one, nodes_one, parent_runtime, 0, max_leeway_one);
 
-            // Calculate leeway needed for second group vs. first group ^
-            double max_leeway_two = std::max<double>(0, (run_one - wait_two));
-            double best_leeway_two = calculateLeewayBinarySearch(run_two, nodes_two, run_one, 0, max_leeway_two);
+                std::cout << "1: leeway needed: " << best_leeway_one << std::endl;
 
-            std::cout << "2: leeway needed: " << best_leeway_two << std::endl;
+                if (best_leeway_one > (run_one * .1)) {
+                    std::cout << "Too much leeway needed - skipping group\n";
+                    continue;
+                }
 
-            if (best_leeway_two > (run_two * .1)) {
-                std::cout << "Too much leeway needed for grouping\n";
-                continue;
-            }
+                // Adjust the run and wait times for leeway
+                if (best_leeway_one > 0) {
+                    run_one += best_leeway_one;
+                    wait_one = this->estimateWaitTime(nodes_one, run_one);
+                    std::cout << "1: recalculated wait_time: " << wait_one << std::endl;
+                    std::cout << "1: recalculated runtime: " << run_one << std::endl;
+                }
 
-            // Adjust the run and wait times for leeway
-            if (best_leeway_two > 0) {
-                run_two += best_leeway_two;
-                wait_two = this->proxyWMS->estimateWaitTime(nodes_two, run_two,
-                                                            this->simulation->getCurrentSimulatedDate(), &sequence);
-                std::cout << "2: recalculated wait_time: " << wait_two << std::endl;
-                std::cout << "2: recalculated runtime: " << run_two << std::endl;
-            }
+                std::tuple<double, double, unsigned long> rest = estimateJob(i + 1, end_level, run_one);
+                double wait_two = std::get<0>(rest);
+                double run_two = std::get<1>(rest);
+                unsigned long nodes_two = std::get<2>(rest);
 
-            double makespan = wait_one + std::max<double>(run_one, wait_two) + run_two;
+                std::cout << "2: num nodes: " << nodes_two << std::endl;
+                std::cout << "2: wait_time: " << wait_two << std::endl;
+                std::cout << "2: runtime: " << run_two << std::endl;
 
-            std::cout << "makespan: " << makespan << std::endl;
+                // Calculate leeway needed for second group vs. first group ^
+                double max_leeway_two = std::max<double>(0, (run_one - wait_two));
+                double best_leeway_two = calculateLeewayBinarySearch(run_two, nodes_two, run_one, 0, max_leeway_two);
 
-            // Make sure we only compare when one_job-0 is still the best grouping
-            // Although, i'm not entirely convinced this is still right...
-            double adjusted_time = makespan;
-            if (partial_dag_end_level == end_level) {
-                makespan += (makespan * beat_bound);
-                std::cout << "makespan after beat bound adjustment: " << makespan << std::endl;
-            }
+                std::cout << "2: leeway needed: " << best_leeway_two << std::endl;
 
-            if (adjusted_time < best_makespan) {
-                std::cout << "found a better split! @ end level = " << i << std::endl;
-                partial_dag_end_level = i;
-                best_makespan = makespan;
-                requested_execution_time = run_one;
-                requested_parallelism = nodes_one;
-                estimated_wait_time = wait_one;
+                if (best_leeway_two > (run_two * .1)) {
+                    std::cout << "Too much leeway needed for grouping\n";
+                    continue;
+                }
+
+                // Adjust the run and wait times for leeway
+                if (best_leeway_two > 0) {
+                    run_two += best_leeway_two;
+                    wait_two = this->estimateWaitTime(nodes_two, run_two);
+                    std::cout << "2: recalculated wait_time: " << wait_two << std::endl;
+                    std::cout << "2: recalculated runtime: " << run_two << std::endl;
+                }
+
+                double makespan = wait_one + std::max<double>(run_one, wait_two) + run_two;
+
+                std::cout << "makespan: " << makespan << std::endl;
+
+                // Make sure we only compare when one_job-0 is still the best grouping
+                // Although, i'm not entirely convinced this is still right...
+                double adjusted_time = makespan;
+                if (partial_dag_end_level == end_level) {
+                    makespan += (makespan * beat_bound);
+                    std::cout << "makespan after beat bound adjustment: " << makespan << std::endl;
+                }
+
+                if (adjusted_time < best_makespan) {
+                    std::cout << "found a better split! @ end level = " << i << std::endl;
+                    partial_dag_end_level = i;
+                    best_makespan = makespan;
+                    requested_execution_time = run_one;
+                    requested_parallelism = nodes_one;
+                    estimated_wait_time = wait_one;
+                }
             }
         }
 
@@ -205,6 +318,13 @@ namespace wrench {
         std::cout << "Parallelism: " << requested_parallelism << std::endl;
 
         Globals::sim_json["end_levels"].push_back(partial_dag_end_level);
+        Globals::sim_json["budget_truncated"].push_back(this->budget->wasTruncated());
+        if (Globals::export_pareto_fronts) {
+            Globals::sim_json["pareto_fronts"].push_back(
+                    this->pareto_fronts[std::make_tuple(start_level, partial_dag_end_level, parent_runtime)].toJSON());
+        }
+
+        this->previous_num_levels = partial_dag_end_level - start_level + 1;
 
         this->pending_placeholder_job = this->proxyWMS->createAndSubmitPlaceholderJob(
                 requested_execution_time, requested_parallelism, start_level, partial_dag_end_level);
@@ -221,58 +341,372 @@ namespace wrench {
 
         unsigned long max_parallelism = findMaxParallelism(start_level, end_level);
 
-        for (unsigned long i = 1; i <= max_parallelism; i++) {
-            std::tuple<double, double> waitAndRun = estimateWaitAndRunTimes(start_level, end_level, i);
-            double curr_wait = std::get<0>(waitAndRun);
-            double curr_runtime = std::get<1>(waitAndRun);
+        // With a budget, look at the numbers of nodes from coarse to fine, otherwise all at once
+        std::vector<std::vector<unsigned long>> rounds;
+        if (this->budget->isLimited()) {
+            rounds = DecisionBudget::coarseToFine(1, max_parallelism);
+        } else {
+            rounds.push_back({});
+            for (unsigned long i = 1; i <= max_parallelism; i++) {
+                rounds[0].push_back(i);
+            }
+        }
 
-            if (isTooWasteful(curr_runtime, i, start_level, end_level)) {
-                continue;
+        // Candidates are ranked in the order they are listed, and the last one wins ties. Those that can't
+        // beat the best one are skipped, unless they may be on the Pareto front.
+        unsigned long best_rank = ULONG_MAX;
+        bool prune = not ParetoFront::isEnabled();
+        ParetoFront &pareto_front = this->pareto_fronts[std::make_tuple(start_level, end_level, delay)];
+        pareto_front.clear();
+        std::map<unsigned long, std::pair<double, double>> evaluated; // num nodes -> (wait time, runtime)
+        auto cannot_win = [prune, &best_rank, &best_makespan](double bound, unsigned long rank) -> bool {
+            return prune and (best_rank != ULONG_MAX) and
+                   ((bound > best_makespan) or ((bound == best_makespan) and (rank < best_rank)));
+        };
+
+        unsigned long first_rank = 0;
+        for (auto const &round : rounds) {
+            // Only stop once there is a viable number of nodes
+            if ((runtime != DBL_MAX) and this->budget->isExhausted()) {
+                break;
             }
 
-            double curr_makespan = std::max<double>(delay, curr_wait) + curr_runtime;
+            std::vector<double> bounds;
+            for (auto i : round) {
+                bounds.push_back(getRuntimeLowerBound(start_level, end_level, i));
+            }
 
-            if (curr_makespan <= best_makespan) {
-                runtime = curr_runtime;
-                wait_time = curr_wait;
-                best_makespan = curr_makespan;
-                best_parallelism = i;
+            for (auto const &batch : WorkflowUtil::getBatchesByBound(bounds, Globals::num_threads)) {
+                // Compute the makespans of the candidates that may be viable and win, in parallel
+                std::vector<unsigned long> batch_candidates;
+                std::vector<unsigned long> nodes;
+                for (auto c : batch) {
+                    if (isTooWasteful(bounds[c], round[c], start_level, end_level) or
+                        cannot_win(std::max<double>(delay, 0) + bounds[c], first_rank + c)) {
+                        if (this->runtime_estimates.find(std::make_tuple(start_level, end_level, round[c])) ==
+                            this->runtime_estimates.end()) {
+                            Globals::num_pruned_makespan_estimates++;
+                        }
+                        continue;
+                    }
+                    batch_candidates.push_back(c);
+                    nodes.push_back(round[c]);
+                }
+                estimateRuntimes({std::make_pair(start_level, end_level)}, nodes);
+
+                // Get the wait times of all the candidates that aren't too wasteful and may still win at once
+                std::vector<unsigned long> candidate_ranks;
+                std::vector<std::tuple<unsigned long, double>> candidates;
+                for (auto c : batch_candidates) {
+                    double curr_runtime = estimateRuntime(start_level, end_level, round[c]);
+                    if (isTooWasteful(curr_runtime, round[c], start_level, end_level)) {
+                        continue;
+                    }
+                    if (cannot_win(std::max<double>(delay, 0) + curr_runtime, first_rank + c)) {
+                        Globals::num_pruned_wait_time_estimates++;
+                        continue;
+                    }
+                    candidate_ranks.push_back(first_rank + c);
+                    candidates.push_back(std::make_tuple(round[c], curr_runtime));
+                }
+                std::vector<double> wait_times = estimateWaitTimes(candidates);
+
+                for (unsigned long c = 0; c < candidates.size(); c++) {
+                    unsigned long i = std::get<0>(candidates[c]);
+                    double curr_runtime = std::get<1>(candidates[c]);
+                    double curr_wait = wait_times[c];
+
+                    double curr_makespan = std::max<double>(delay, curr_wait) + curr_runtime;
+                    pareto_front.add(i, curr_makespan, i * curr_runtime);
+                    evaluated[i] = std::make_pair(curr_wait, curr_runtime);
+
+                    if ((curr_makespan < best_makespan) or
+                        ((curr_makespan == best_makespan) and ((best_rank == ULONG_MAX) or (candidate_ranks[c] > best_rank)))) {
+                        runtime = curr_runtime;
+                        wait_time = curr_wait;
+                        best_makespan = curr_makespan;
+                        best_parallelism = i;
+                        best_rank = candidate_ranks[c];
+                    }
+                }
             }
+            first_rank += round.size();
         }
 
         assert(runtime != DBL_MAX && wait_time != DBL_MAX);
 
+        if (ParetoFront::isUsedForChoice()) {
+            best_parallelism = pareto_front.pick(Globals::pareto_weight);
+            wait_time = evaluated[best_parallelism].first;
+            runtime = evaluated[best_parallelism].second;
+        }
+
         return std::make_tuple(wait_time, runtime, best_parallelism);
     }
 
     unsigned long GlumeWMS::findMaxParallelism(unsigned long start_level, unsigned long end_level) {
         unsigned long max_parallelism = 0;
         for (unsigned long i = start_level; i <= end_level; i++) {
-            unsigned long num_tasks_in_level = this->getWorkflow()->getTasksInTopLevelRange(i, i).size();
+            unsigned long num_tasks_in_level = this->level_num_tasks[i];
             max_parallelism = std::max<unsigned long>(max_parallelism, num_tasks_in_level);
         }
 
         return std::min<unsigned long>(max_parallelism, this->number_of_hosts);
     }
 
-    std::tuple<double, double>
-    GlumeWMS::estimateWaitAndRunTimes(unsigned long start_level, unsigned long end_level,
-                                               unsigned long nodes) {
+    /**
+     * @brief Estimate the makespan of a range of levels on a number of nodes (memoized)
+     * @param start_level: the first level
+     * @param end_level: the last level
+     * @param nodes: the number of nodes
+     * @return the estimated makespan
+     */
+    double GlumeWMS::estimateRuntime(unsigned long start_level, unsigned long end_level, unsigned long nodes) {
+        auto key = std::make_tuple(start_level, end_level, nodes);
+        auto it = this->runtime_estimates.find(key);
+        if (it != this->runtime_estimates.end()) {
+            return it->second;
+        }
         double runtime = WorkflowUtil::estimateMakespan(
                 this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level),
                 nodes, this->core_speed);
+        this->runtime_estimates[key] = runtime;
+        return runtime;
+    }
+
+    /**
+     * @brief Get a lower bound on the makespan of a range of levels on a number of nodes
+     * @param start_level: the first level
+     * @param end_level: the last level
+     * @param nodes: the number of nodes
+     * @return the lower bound
+     */
+    double GlumeWMS::getRuntimeLowerBound(unsigned long start_level, unsigned long end_level, unsigned long nodes) {
+        auto key = std::make_pair(start_level, end_level);
+        auto it = this->runtime_bounds.find(key);
+        if (it == this->runtime_bounds.end()) {
+            it = this->runtime_bounds.insert(std::make_pair(key, WorkflowUtil::getMakespanBounds(
+                    this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level), this->core_speed))).first;
+        }
+        return WorkflowUtil::getMakespanLowerBound(it->second, nodes);
+    }
+
+    /**
+     * @brief Estimate the makespans of ranges of levels for all numbers of nodes up to their max parallelism
+     *        (or for some numbers of nodes only), in parallel, for those not already known
+     * @param ranges: a list of (start level, end level) ranges
+     * @param nodes: the numbers of nodes to look at (all of them if empty)
+     */
+    void GlumeWMS::estimateRuntimes(std::vector<std::pair<unsigned long, unsigned long>> ranges,
+                                    std::vector<unsigned long> nodes) {
+        std::vector<std::tuple<unsigned long, unsigned long, unsigned long>> keys;
+        std::vector<std::vector<WorkflowTask *>> range_tasks(ranges.size());
+        std::vector<std::tuple<std::vector<WorkflowTask *> *, unsigned long>> configurations;
+
+        for (unsigned long r = 0; r < ranges.size(); r++) {
+            unsigned long start_level = ranges[r].first;
+            unsigned long end_level = ranges[r].second;
+            std::vector<unsigned long> range_nodes = nodes;
+            if (range_nodes.empty()) {
+                for (unsigned long i = 1; i <= findMaxParallelism(start_level, end_level); i++) {
+                    range_nodes.push_back(i);
+                }
+            }
+            for (auto i : range_nodes) {
+                auto key = std::make_tuple(start_level, end_level, i);
+                if (this->runtime_estimates.find(key) != this->runtime_estimates.end()) {
+                    continue;
+                }
+                if (range_tasks[r].empty()) {
+                    range_tasks[r] = this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level);
+                }
+                // Insert a placeholder so that duplicate ranges are computed once
+                this->runtime_estimates[key] = -1.0;
+                keys.push_back(key);
+                configurations.push_back(std::make_tuple(&(range_tasks[r]), i));
+            }
+        }
+
+        std::vector<double> runtimes = WorkflowUtil::estimateMakespans(configurations, this->core_speed);
+        for (unsigned long k = 0; k < keys.size(); k++) {
+            this->runtime_estimates[keys[k]] = runtimes[k];
+        }
+    }
+
+    /**
+     * @brief Estimate the queue wait time of a job (memoized until the next grouping decision)
+     * @param nodes: the number of nodes
+     * @param runtime: the requested runtime
+     * @return the estimated wait time
+     */
+    double GlumeWMS::estimateWaitTime(unsigned long nodes, double runtime) {
+        auto key = std::make_pair(nodes, runtime);
+        auto it = this->wait_time_estimates.find(key);
+        if (it != this->wait_time_estimates.end()) {
+            return it->second;
+        }
         double wait_time = this->proxyWMS->estimateWaitTime(nodes, runtime,
                                                             this->simulation->getCurrentSimulatedDate(), &sequence);
-        return std::make_tuple(wait_time, runtime);
+        this->wait_time_estimates[key] = wait_time;
+        return wait_time;
+    }
+
+    /**
+     * @brief Estimate the queue wait times of several jobs, querying the batch service once for
+     *        those not already known
+     * @param configurations: a list of (num nodes, runtime) job configurations
+     * @return the wait time of each configuration, in the same order
+     */
+    std::vector<double> GlumeWMS::estimateWaitTimes(std::vector<std::tuple<unsigned long, double>> configurations) {
+        std::vector<std::tuple<unsigned long, double>> unknown_configurations;
+        for (auto const &config : configurations) {
+            if (this->wait_time_estimates.find(std::make_pair(std::get<0>(config), std::get<1>(config))) ==
+                this->wait_time_estimates.end()) {
+                unknown_configurations.push_back(config);
+            }
+        }
+
+        std::vector<double> unknown_wait_times = this->proxyWMS->estimateWaitTimes(
+                unknown_configurations, this->simulation->getCurrentSimulatedDate(), &sequence);
+        for (unsigned long c = 0; c < unknown_configurations.size(); c++) {
+            this->wait_time_estimates[std::make_pair(std::get<0>(unknown_configurations[c]),
+                                                     std::get<1>(unknown_configurations[c]))] = unknown_wait_times[c];
+        }
+
+        std::vector<double> wait_times;
+        for (auto const &config : configurations) {
+            wait_times.push_back(this->wait_time_estimates[std::make_pair(std::get<0>(config), std::get<1>(config))]);
+        }
+        return wait_times;
+    }
+
+    /**
+     * @brief Estimate a job for a range of levels that is submitted when its parent job starts, with the
+     *        leeway needed to cover the parent's runtime added to its runtime
+     * @param start_level: the first level
+     * @param end_level: the last level
+     * @param parent_runtime: the runtime of the parent job
+     * @return (wait time, runtime, num_hosts), with a DBL_MAX wait time if too much leeway is needed
+     */
+    std::tuple<double, double, unsigned long>
+    GlumeWMS::estimateJobWithLeeway(unsigned long start_level, unsigned long end_level, double parent_runtime) {
+        std::tuple<double, double, unsigned long> job = estimateJob(start_level, end_level, parent_runtime);
+        double wait_time = std::get<0>(job);
+        double runtime = std::get<1>(job);
+        unsigned long nodes = std::get<2>(job);
+
+        double max_leeway = std::max<double>(0, (parent_runtime - wait_time));
+        double best_leeway = calculateLeewayBinarySearch(runtime, nodes, parent_runtime, 0, max_leeway);
+
+        if (best_leeway > (runtime * .1)) {
+            return std::make_tuple(DBL_MAX, runtime, nodes);
+        }
+
+        if (best_leeway > 0) {
+            runtime += best_leeway;
+            wait_time = estimateWaitTime(nodes, runtime);
+        }
+
+        return std::make_tuple(wait_time, runtime, nodes);
+    }
+
+    /**
+     * @brief Estimate a group of levels that is planned after the first one, regardless of when the group
+     *        before it starts (memoized until the next grouping decision), so that only O(L^2) groups are
+     *        ever estimated for L levels
+     * @param start_level: the first level
+     * @param end_level: the last level
+     * @return (wait time, runtime, num_hosts)
+     */
+    std::tuple<double, double, unsigned long> GlumeWMS::estimateGroup(unsigned long start_level,
+                                                                      unsigned long end_level) {
+        auto key = std::make_pair(start_level, end_level);
+        auto it = this->group_estimates.find(key);
+        if (it == this->group_estimates.end()) {
+            it = this->group_estimates.insert(std::make_pair(key, estimateJob(start_level, end_level, 0))).first;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Find the best partition of a range of levels into consecutive groups, each group being
+     *        submitted when the previous one starts (memoized until the next grouping decision). The groups
+     *        are estimated with estimateGroup(), so the runtime of the group before the range only depends
+     *        on where that group starts, which is what results are memoized by.
+     * @param start_level: the first level
+     * @param end_level: the last level
+     * @param previous_start_level: the first level of the group before the range
+     * @param parent_runtime: the runtime of the group before the range
+     * @return (time from the start of the previous group to the end of the last group, end level of the first group),
+     *         with a DBL_MAX time if no partition is viable
+     */
+    std::tuple<double, unsigned long>
+    GlumeWMS::findBestPartition(unsigned long start_level, unsigned long end_level,
+                                unsigned long previous_start_level, double parent_runtime) {
+        auto key = std::make_pair(start_level, previous_start_level);
+        auto it = this->partition_estimates.find(key);
+        if (it != this->partition_estimates.end()) {
+            return it->second;
+        }
+
+        std::tuple<double, unsigned long> best = std::make_tuple(DBL_MAX, end_level);
+
+        // If time is limited, make sure the single group is looked at first
+        std::vector<unsigned long> group_end_levels;
+        if (this->budget->isLimited()) {
+            group_end_levels.push_back(end_level);
+            if (start_level < end_level) {
+                for (auto i : DecisionBudget::promiseOrder(start_level, end_level - 1,
+                                                           start_level + this->previous_num_levels - 1)) {
+                    group_end_levels.push_back(i);
+                }
+            }
+        } else {
+            for (unsigned long i = start_level; i <= end_level; i++) {
+                group_end_levels.push_back(i);
+            }
+        }
+
+        for (auto i : group_end_levels) {
+            if ((std::get<0>(best) != DBL_MAX) and this->budget->isExhausted()) {
+                break;
+            }
+            // Each group runs after the previous one started
+            double bound = parent_runtime + getRuntimeLowerBound(start_level, i, findMaxParallelism(start_level, i));
+            if (i < end_level) {
+                bound += getRuntimeLowerBound(i + 1, end_level, findMaxParallelism(i + 1, end_level));
+            }
+            if (bound >= std::get<0>(best)) {
+                Globals::num_pruned_splits++;
+                continue;
+            }
+            std::tuple<double, double, unsigned long> group = estimateGroup(start_level, i);
+            double wait_time = std::get<0>(group);
+            double runtime = std::get<1>(group);
+
+            double rest = runtime;
+            if (i < end_level) {
+                rest = std::get<0>(findBestPartition(i + 1, end_level, start_level, runtime));
+                if (rest == DBL_MAX) {
+                    continue;
+                }
+            }
+
+            double time = std::max<double>(parent_runtime, wait_time) + rest;
+            if (time < std::get<0>(best)) {
+                best = std::make_tuple(time, i);
+            }
+        }
+
+        this->partition_estimates[key] = best;
+        return best;
     }
 
     bool GlumeWMS::isTooWasteful(double runtime, unsigned long nodes, unsigned long start_level,
                                           unsigned long end_level) {
         double all_tasks_time = 0;
         for (unsigned long i = start_level; i <= end_level; i++) {
-            all_tasks_time += WorkflowUtil::estimateMakespan(
-                    this->getWorkflow()->getTasksInTopLevelRange(i, i),
-                    1, this->core_speed);
+            all_tasks_time += this->level_sequential_times[i];
         }
 
         double waste_ratio = (nodes * runtime - all_tasks_time) / (nodes * runtime);
@@ -293,8 +727,7 @@ namespace wrench {
 
         double middle = floor((lower + upper) / 2.0);
 
-        double new_wait_time = this->proxyWMS->estimateWaitTime(num_nodes, (runtime + middle),
-                                                                this->simulation->getCurrentSimulatedDate(), &sequence);
+        double new_wait_time = this->estimateWaitTime(num_nodes, (runtime + middle));
         // std::cout << "NEW WAIT TIME: " << new_wait_time << std::endl;
         double new_leeway = parent_runtime - new_wait_time;
 
@@ -335,22 +768,8 @@ namespace wrench {
         this->running_placeholder_jobs.insert(placeholder_job);
         this->pending_placeholder_job = nullptr;
 
-        // std::string output_string = "";
-
-        for (auto task : placeholder_job->tasks) {
-            if (task->getState() == WorkflowTask::State::READY  and (placeholder_job->num_standard_job_submitted < placeholder_job->num_hosts)) {
-                auto standard_job = this->job_manager->createStandardJob(task, {});
-
-                // output_string += " " + task->getID();
-
-                WRENCH_INFO("Submitting task %s as part of placeholder job %ld-%ld",
-                            task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
-                placeholder_job->num_standard_job_submitted++;
-            }
-        }
-
-        this->applyGroupingHeuristic();
+        placeholder_job->start_date = this->simulation->getCurrentSimulatedDate();
+        placeholder_job->initializeReadyTasks();
     }
 
     void GlumeWMS::processEventPilotJobExpiration(std::shared_ptr<PilotJobExpiredEvent> e) {
@@ -373,13 +792,7 @@ namespace wrench {
                     placeholder_job->pilot_job->getName().c_str());
 
         // Check if there are unprocessed tasks
-        bool unprocessed = false;
-        for (auto t : placeholder_job->tasks) {
-            if (t->getState() != WorkflowTask::COMPLETED) {
-                unprocessed = true;
-                break;
-            }
-        }
+        bool unprocessed = placeholder_job->hasUnprocessedTasks();
 
         unsigned long num_used_nodes;
         sscanf(e->pilot_job->getServiceSpecificArguments()["-N"].c_str(), "%lu", &num_used_nodes);
@@ -389,13 +802,24 @@ namespace wrench {
 
         double wasted_node_seconds = 60.0 * num_used_minutes * num_used_nodes;
 
-        for (auto t : placeholder_job->tasks) {
+        for (auto t : placeholder_job->getExecutedTasks()) {
             if (t->getState() == WorkflowTask::State::COMPLETED) {
                 wasted_node_seconds -= t->getFlops() / this->core_speed;
             }
         }
         this->simulator->wasted_node_seconds += wasted_node_seconds;
 
+        // The tasks it took from other placeholder jobs and didn't complete go back to them
+        std::vector<WorkflowTask *> stolen_tasks_to_return;
+        for (auto const &stolen_task : placeholder_job->stolen_tasks) {
+            if (stolen_task.first->getState() != WorkflowTask::State::COMPLETED) {
+                stolen_tasks_to_return.push_back(stolen_task.first);
+            }
+        }
+        for (auto t : stolen_tasks_to_return) {
+            placeholder_job->returnStolenTask(t);
+        }
+
         if (not unprocessed) {
             // Nothing to do
             WRENCH_INFO("This placeholder job has no unprocessed tasks. great.");
@@ -443,8 +867,6 @@ namespace wrench {
         for (auto ph : to_remove) {
             this->running_placeholder_jobs.erase(ph);
         }
-
-        this->applyGroupingHeuristic();
     }
 
     void GlumeWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> e) {
@@ -455,99 +877,157 @@ namespace wrench {
 
         this->simulator->used_node_seconds += completed_task->getFlops() / this->core_speed;
 
-        // Find the placeholder job this task belongs to
+        // Find the running placeholder job this task belongs to, and the one it ran in if it was stolen
         PlaceHolderJob *placeholder_job = nullptr;
+        PlaceHolderJob *host_placeholder_job = nullptr;
         for (auto ph : this->running_placeholder_jobs) {
-            for (auto task : ph->tasks) {
-                if (task == completed_task) {
-                    placeholder_job = ph;
-                    break;
-                }
+            if (ph->hasTask(completed_task)) {
+                placeholder_job = ph;
+            }
+            if (ph->stolen_tasks.find(completed_task) != ph->stolen_tasks.end()) {
+                host_placeholder_job = ph;
             }
         }
 
-        if (placeholder_job != nullptr) {
-
+        if (host_placeholder_job != nullptr) {
+            host_placeholder_job->num_standard_job_submitted--;
+        } else if (placeholder_job != nullptr) {
             placeholder_job->num_standard_job_submitted--;
+        }
+        if (placeholder_job != nullptr) {
+            placeholder_job->markTaskCompleted(completed_task);
+        }
 
-            // Terminate the pilot job in case all its tasks are done
-            bool all_tasks_done = true;
-            for (auto t : placeholder_job->tasks) {
-                if (t->getState() != WorkflowTask::COMPLETED) {
-                    all_tasks_done = false;
-                    break;
-                }
-            }
-            if (all_tasks_done) {
-                // Update the wasted no seconds metric
-                double first_task_start_time = DBL_MAX;
-                for (auto const &t : placeholder_job->tasks) {
-                    if (t->getStartDate() < first_task_start_time) {
-                        first_task_start_time = t->getStartDate();
-                    }
-                }
-                int num_requested_nodes = stoi(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"]);
-                double job_duration = this->simulation->getCurrentSimulatedDate() - first_task_start_time;
-                double wasted_node_seconds = num_requested_nodes * job_duration;
-                for (auto const &t : placeholder_job->tasks) {
-                    wasted_node_seconds -= t->getFlops() / this->core_speed;
-                }
-
-                this->simulator->wasted_node_seconds += wasted_node_seconds;
-
-                WRENCH_INFO("All tasks are completed in this placeholder job, so I am terminating it (%s)",
-                            placeholder_job->pilot_job->getName().c_str());
+        // Cancel the pending pilot job if all its tasks were run by others
+        if ((this->pending_placeholder_job != nullptr) and this->pending_placeholder_job->hasTask(completed_task)) {
+            this->pending_placeholder_job->markTaskCompleted(completed_task);
+            if (this->pending_placeholder_job->areAllTasksCompleted()) {
+                WRENCH_INFO("All tasks of the pending placeholder job were run by others, so I am canceling it (%s)",
+                            this->pending_placeholder_job->pilot_job->getName().c_str());
                 try {
-                    // hmm
-                    WRENCH_INFO("TERMINATING A PILOT JOB");
-                    this->job_manager->terminateJob(placeholder_job->pilot_job);
+                    this->job_manager->terminateJob(this->pending_placeholder_job->pilot_job);
                 } catch (WorkflowExecutionException &e) {
                     // ignore
                 }
-                this->running_placeholder_jobs.erase(placeholder_job);
+                this->pending_placeholder_job = nullptr;
             }
         }
 
-        // Start all newly ready tasks that depended on the completed task, IN ANY PLACEHOLDER
-        std::vector<WorkflowTask *> children = this->getWorkflow()->getTaskChildren(completed_task);
-        for (auto ph : this->running_placeholder_jobs) {
+        // Terminate the pilot jobs in case all their tasks are done
+        for (auto ph : {placeholder_job, host_placeholder_job}) {
+            if ((ph != nullptr) and (this->running_placeholder_jobs.find(ph) != this->running_placeholder_jobs.end()) and
+                ph->isDone()) {
+                terminatePlaceholderJob(ph);
+            }
+        }
 
-            // Start Other tasks if possible, considering first tasks at the same level of completed_task
-            for (auto task : ph->tasks) {
-                if ((task->getState() == WorkflowTask::READY) and
-                (task->getTopLevel() == completed_task->getTopLevel()) and
-                (ph->num_standard_job_submitted < ph->num_hosts)) {
+        // Queue the children that this completion made ready in their placeholder, IN ANY PLACEHOLDER
+        // (including the pending one, whose ready tasks running placeholder jobs can take)
+        for (auto child : this->getWorkflow()->getTaskChildren(completed_task)) {
+            if (child->getState() != WorkflowTask::READY) {
+                continue;
+            }
+            if ((this->pending_placeholder_job != nullptr) and this->pending_placeholder_job->hasTask(child)) {
+                this->pending_placeholder_job->enqueueReadyTask(child);
+                continue;
+            }
+            for (auto ph : this->running_placeholder_jobs) {
+                if (ph->hasTask(child)) {
+                    ph->enqueueReadyTask(child);
+                    break;
+                }
+            }
+        }
+    }
 
-                    auto standard_job = this->job_manager->createStandardJob(task, {});
-                    // hmm
-                    WRENCH_INFO("Submitting task %s  as part of placeholder job %ld-%ld",
-                                task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                    this->job_manager->submitJob(standard_job, ph->pilot_job->getComputeService());
+    /**
+     * @brief Submit the ready tasks of all running placeholder jobs, once all the events at the current
+     *        date have been processed
+     */
+    void GlumeWMS::dispatchAllReadyTasks() {
+        for (auto ph : this->running_placeholder_jobs) {
+            this->proxyWMS->dispatchReadyTasks(ph);
+        }
 
-                    ph->num_standard_job_submitted++;
-                }
+        // Hosts that are still idle can run the next group's tasks
+        if (Globals::work_stealing and (this->pending_placeholder_job != nullptr)) {
+            for (auto ph : this->running_placeholder_jobs) {
+                this->dispatchStolenTasks(ph, this->pending_placeholder_job);
             }
+        }
+    }
 
-            // Start Any other READY TASKS if possible
-            for (auto task : ph->tasks) {
-                if ((task->getState() == WorkflowTask::READY) and (ph->num_standard_job_submitted < ph->num_hosts)) {
+    /**
+     * @brief Terminate a running placeholder job whose tasks are all done, and account for its wasted node time
+     * @param placeholder_job: a running placeholder job
+     */
+    void GlumeWMS::terminatePlaceholderJob(PlaceHolderJob *placeholder_job) {
+        // Update the wasted no seconds metric
+        double first_task_start_time = DBL_MAX;
+        for (auto const &t : placeholder_job->getExecutedTasks()) {
+            if (t->getStartDate() < first_task_start_time) {
+                first_task_start_time = t->getStartDate();
+            }
+        }
+        int num_requested_nodes = stoi(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"]);
+        double job_duration = this->simulation->getCurrentSimulatedDate() - first_task_start_time;
+        double wasted_node_seconds = num_requested_nodes * job_duration;
+        for (auto const &t : placeholder_job->getExecutedTasks()) {
+            wasted_node_seconds -= t->getFlops() / this->core_speed;
+        }
 
-                        auto standard_job = this->job_manager->createStandardJob(task, {});
-                        // hmm
-                        WRENCH_INFO("Submitting task %s  as part of placeholder job %ld-%ld",
-                                    task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                        this->job_manager->submitJob(standard_job, ph->pilot_job->getComputeService());
+        this->simulator->wasted_node_seconds += wasted_node_seconds;
 
-                        ph->num_standard_job_submitted++;
+        WRENCH_INFO("All tasks are completed in this placeholder job, so I am terminating it (%s)",
+                    placeholder_job->pilot_job->getName().c_str());
+        try {
+            // hmm
+            WRENCH_INFO("TERMINATING A PILOT JOB");
+            this->job_manager->terminateJob(placeholder_job->pilot_job);
+        } catch (WorkflowExecutionException &e) {
+            // ignore
+        }
+        this->running_placeholder_jobs.erase(placeholder_job);
+    }
 
-                }
+    /**
+     * @brief Submit ready tasks of another placeholder job to the idle hosts of a running placeholder job
+     * @param placeholder_job: a running placeholder job
+     * @param victim: the placeholder job to take tasks from
+     */
+    void GlumeWMS::dispatchStolenTasks(PlaceHolderJob *placeholder_job, PlaceHolderJob *victim) {
+        while (placeholder_job->num_standard_job_submitted < placeholder_job->num_hosts) {
+            WorkflowTask *task = placeholder_job->stealReadyTask(victim, this->simulation->getCurrentSimulatedDate(),
+                                                                 this->core_speed);
+            if (task == nullptr) {
+                break;
             }
+
+            auto standard_job = this->job_manager->createStandardJob(task, {});
+            WRENCH_INFO("Submitting task %s of placeholder job %ld-%ld as part of placeholder job %ld-%ld",
+                        task->getID().c_str(), victim->start_level, victim->end_level,
+                        placeholder_job->start_level, placeholder_job->end_level);
+            this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
+            placeholder_job->num_standard_job_submitted++;
         }
     }
 
     void GlumeWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> e) {
+        WorkflowTask *failed_task = e->standard_job->tasks[0];
+
+        // A stolen task that couldn't complete goes back to the placeholder job it belongs to
+        for (auto ph : this->running_placeholder_jobs) {
+            PlaceHolderJob *owner = ph->returnStolenTask(failed_task);
+            if (owner != nullptr) {
+                ph->num_standard_job_submitted--;
+                WRENCH_INFO("Stolen task %s failed, giving it back to placeholder job %ld-%ld",
+                            failed_task->getID().c_str(), owner->start_level, owner->end_level);
+                return;
+            }
+        }
+
         WRENCH_INFO("Got a standard job failure event for task %s -- IGNORING THIS",
-                    e->standard_job->tasks[0]->getID().c_str());
+                    failed_task->getID().c_str());
         throw std::runtime_error("A job has failed, which shouldn't happen");
     }
 
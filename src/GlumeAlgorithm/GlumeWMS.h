@@ -16,6 +16,8 @@
 #include "Simulator.h"
 #include <Util/PlaceHolderJob.h>
 #include <Util/ProxyWMS.h>
+#include <Util/DecisionBudget.h>
+#include <Util/ParetoFront.h>
 
 namespace wrench {
 
@@ -23,7 +25,7 @@ namespace wrench {
 
     public:
 
-        GlumeWMS(Simulator *simulator, std::string hostname, double waste_bound, double beat_bound,
+        GlumeWMS(Simulator *simulator, std::string hostname, double waste_bound, double beat_bound, bool multiway,
                           std::shared_ptr<BatchComputeService> batch_service);
 
     private:
@@ -39,8 +41,25 @@ namespace wrench {
 
         unsigned long findMaxParallelism(unsigned long start_level, unsigned long end_level);
 
-        std::tuple<double, double>
-        estimateWaitAndRunTimes(unsigned long start_level, unsigned long end_level, unsigned long nodes);
+        double estimateRuntime(unsigned long start_level, unsigned long end_level, unsigned long nodes);
+
+        double getRuntimeLowerBound(unsigned long start_level, unsigned long end_level, unsigned long nodes);
+
+        void estimateRuntimes(std::vector<std::pair<unsigned long, unsigned long>> ranges,
+                              std::vector<unsigned long> nodes = {});
+
+        double estimateWaitTime(unsigned long nodes, double runtime);
+
+        std::vector<double> estimateWaitTimes(std::vector<std::tuple<unsigned long, double>> configurations);
+
+        std::tuple<double, double, unsigned long>
+        estimateJobWithLeeway(unsigned long start_level, unsigned long end_level, double parent_runtime);
+
+        std::tuple<double, double, unsigned long> estimateGroup(unsigned long start_level, unsigned long end_level);
+
+        std::tuple<double, unsigned long>
+        findBestPartition(unsigned long start_level, unsigned long end_level, unsigned long previous_start_level,
+                          double parent_runtime);
 
         bool isTooWasteful(double runtime, unsigned long nodes, unsigned long start_level,
                                               unsigned long end_level);
@@ -56,10 +75,17 @@ namespace wrench {
 
         void processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> e) override;
 
+        void dispatchAllReadyTasks();
+
+        void dispatchStolenTasks(PlaceHolderJob *placeholder_job, PlaceHolderJob *victim);
+
+        void terminatePlaceholderJob(PlaceHolderJob *placeholder_job);
+
         Simulator *simulator;
 
         double waste_bound;
         double beat_bound;
+        bool multiway;
 
         std::set<PlaceHolderJob *> running_placeholder_jobs;
         PlaceHolderJob *pending_placeholder_job;
@@ -70,6 +96,37 @@ namespace wrench {
         ProxyWMS *proxyWMS;
 
         unsigned long number_of_splits;
+
+        DecisionBudget *budget;
+
+        // Number of levels in the group picked by the previous decision (0 if none)
+        unsigned long previous_num_levels;
+
+        // Per-level task counts and sequential execution times (the workflow never changes)
+        std::vector<unsigned long> level_num_tasks;
+        std::vector<double> level_sequential_times;
+
+        // Makespan estimates keyed by (start level, end level, num nodes), valid for the whole execution
+        std::map<std::tuple<unsigned long, unsigned long, unsigned long>, double> runtime_estimates;
+
+        // Makespan bounds (see WorkflowUtil::getMakespanBounds()) keyed by (start level, end level), valid for the
+        // whole execution
+        std::map<std::pair<unsigned long, unsigned long>, std::tuple<double, double, double>> runtime_bounds;
+
+        // Wait time estimates keyed by (num nodes, runtime), valid for one grouping decision only
+        std::map<std::pair<unsigned long, double>, double> wait_time_estimates;
+
+        // Candidates of the number-of-nodes choices keyed by (start level, end level, delay), valid for one grouping
+        // decision only
+        std::map<std::tuple<unsigned long, unsigned long, double>, ParetoFront> pareto_fronts;
+
+        // Estimates of the groups planned after the first one keyed by (start level, end level), valid for one
+        // grouping decision only
+        std::map<std::pair<unsigned long, unsigned long>, std::tuple<double, double, unsigned long>> group_estimates;
+
+        // Best (remaining time, end level of next group) keyed by (next group start level, previous group start
+        // level), valid for one grouping decision only
+        std::map<std::pair<unsigned long, unsigned long>, std::tuple<double, unsigned long>> partition_estimates;
     };
 
 };
@@ -8,13 +8,16 @@
  */
 
 
+#include <cfloat>
 #include <wms/WMS.h>
 #include <workflow/job/PilotJob.h>
 #include <logging/TerminalOutput.h>
 #include <managers/JobManager.h>
 #include <StaticClusteringAlgorithms/ClusteredJob.h>
 #include <StaticClusteringAlgorithms/StaticClusteringWMS.h>
+#include <Util/WorkflowUtil.h>
 #include "Simulator.h"
+#include "Globals.h"
 #include "LevelByLevelWMS.h"
 #include "OngoingLevel.h"
 
@@ -26,15 +29,18 @@ namespace wrench {
 
     LevelByLevelWMS::LevelByLevelWMS(Simulator *simulator, std::string hostname, bool overlap,
                                      std::string clustering_spec,
-                                     std::shared_ptr<BatchComputeService> batch_service) :
+                                     std::shared_ptr<BatchComputeService> batch_service,
+                                     unsigned long lookahead_depth, bool timed_submissions) :
             WMS(nullptr, nullptr, {batch_service}, {}, {}, nullptr, hostname, "clustering_wms") {
         this->simulator = simulator;
         this->overlap = overlap;
         this->batch_service = batch_service;
         this->clustering_spec = clustering_spec;
-
-        // TODO - Overlapping is broken due to leeway issues
-        assert(not this->overlap);
+        // Without overlap, a level is submitted once the previous one is done
+        this->lookahead_depth = this->overlap ? lookahead_depth : 1;
+        this->timed_submissions = timed_submissions;
+        this->next_level = nullptr;
+        this->next_submission_date = DBL_MAX;
     }
 
 
@@ -56,8 +62,19 @@ namespace wrench {
 
             submitPilotJobsForNextLevel();
 
-            this->waitForAndProcessNextEvent();
+            // Wake up to submit the next level on time, if its submission was deferred
+            if (this->next_submission_date < DBL_MAX) {
+                double timeout = std::max<double>(0, this->next_submission_date -
+                                                     this->simulation->getCurrentSimulatedDate());
+                this->waitForAndProcessNextEvent(timeout);
+            } else {
+                this->waitForAndProcessNextEvent();
+            }
 
+            // Hosts that are idle can run the tasks of the placeholder jobs that haven't started yet
+            if (Globals::work_stealing) {
+                this->dispatchStolenTasks();
+            }
         }
 
         return 0;
@@ -68,14 +85,12 @@ namespace wrench {
 
         WRENCH_INFO("Seeing if I can submit jobs for the 'next' level...");
 
-        // If more than 2 levels are going on, forget it
-        if (this->ongoing_levels.size() >= 2) {
+        this->next_submission_date = DBL_MAX;
 
-            WRENCH_INFO("Too many ongoing levels going on... will try later");
-            return;
-        }
+        // If too many levels are going on, forget it
+        if (this->ongoing_levels.size() >= this->lookahead_depth) {
 
-        if (not(this->overlap or ongoing_levels.empty())) {
+            WRENCH_INFO("Too many ongoing levels going on... will try later");
             return;
         }
 
@@ -86,7 +101,7 @@ namespace wrench {
 
         for (auto l : this->ongoing_levels) {
             ulong level_number = l.second->level_number;
-            if (level_to_submit < level_number) {
+            if ((level_to_submit == ULONG_MAX) or (level_to_submit < level_number)) {
                 level_to_submit = level_number;
             }
         }
@@ -106,9 +121,11 @@ namespace wrench {
             return;
         }
 
-        // Make sure that all PH jobs in the previous level have started
-        if (level_to_submit > 0 and (this->ongoing_levels.find(level_to_submit) != this->ongoing_levels.end())) {
-            if (not(this->ongoing_levels[level_to_submit - 1]->pending_placeholder_jobs.empty())) {
+        // Make sure that all PH jobs in the previous level have started (unless submissions are timed)
+        OngoingLevel *previous_level = nullptr;
+        if (level_to_submit > 0 and (this->ongoing_levels.find(level_to_submit - 1) != this->ongoing_levels.end())) {
+            previous_level = this->ongoing_levels[level_to_submit - 1];
+            if ((not this->timed_submissions) and (not(previous_level->pending_placeholder_jobs.empty()))) {
 
                 WRENCH_INFO(
                         "Cannot submit pilot jobs for level %ld since level %ld still has "
@@ -118,36 +135,73 @@ namespace wrench {
             }
         }
 
-        if (level_to_submit > 0) {
+        // Create all placeholder jobs for level (once, as a timed submission may be deferred)
+        if ((this->next_level == nullptr) or (this->next_level->level_number != level_to_submit)) {
 
-            WRENCH_INFO("All pilot jobs from level %ld have started... off I go with level %ld!",
-                        level_to_submit - 1, level_to_submit);
+            WRENCH_INFO("Creating a new ongoing level for level %lu", level_to_submit);
 
-        } else {
+//        printf("Creating a new ongoing level for level %lu of %lu\n", level_to_submit, (this->getWorkflow()->getNumLevels() - 1));
 
-            WRENCH_INFO("Starting the first level!");
+            this->next_level = new OngoingLevel();
+            this->next_level->level_number = level_to_submit;
+            this->next_level->pending_placeholder_jobs = createPlaceHolderJobsForLevel(level_to_submit);
+        }
+        OngoingLevel *new_ongoing_level = this->next_level;
 
+        // The inputs of the level are ready when the previous level completes
+        double now = this->simulation->getCurrentSimulatedDate();
+        double inputs_ready_date = now;
+        if (previous_level != nullptr) {
+            inputs_ready_date = std::max<double>(now, previous_level->getPredictedCompletionDate());
         }
 
-        WRENCH_INFO("Creating a new ongoing level for level %lu", level_to_submit);
+        // Predict when the pilot jobs would start if submitted now (only needed if the inputs aren't ready)
+        std::map<PlaceHolderJob *, double> makespans;
+        std::map<PlaceHolderJob *, double> predicted_start_dates;
+        for (auto ph : new_ongoing_level->pending_placeholder_jobs) {
+            makespans[ph] = ph->clustered_job->estimateMakespan(this->core_speed);
+            predicted_start_dates[ph] = now;
+        }
+        if (inputs_ready_date > now) {
+            predicted_start_dates = this->estimateStartDates(new_ongoing_level->pending_placeholder_jobs, makespans);
+        }
 
-//        printf("Creating a new ongoing level for level %lu of %lu\n", level_to_submit, (this->getWorkflow()->getNumLevels() - 1));
+        // With timed submissions, wait until the pilot jobs are predicted to start when their inputs are ready
+        if (this->timed_submissions) {
+            double latest_start_date = now;
+            for (auto const &start_date : predicted_start_dates) {
+                latest_start_date = std::max<double>(latest_start_date, start_date.second);
+            }
+            if (latest_start_date < inputs_ready_date) {
+                this->next_submission_date = now + (inputs_ready_date - latest_start_date);
+                WRENCH_INFO("Level %lu's pilot jobs would start %.2lf seconds before their inputs are ready... "
+                            "will submit them at date %.2lf", level_to_submit, inputs_ready_date - latest_start_date,
+                            this->next_submission_date);
+                return;
+            }
+        }
+
+        if (level_to_submit > 0) {
 
-        OngoingLevel *new_ongoing_level = new OngoingLevel();
-        new_ongoing_level->level_number = level_to_submit;
+            WRENCH_INFO("Off I go with level %ld!", level_to_submit);
 
-        // Create all placeholder jobs for level
-        std::set<PlaceHolderJob *> placeholder_jobs;
+        } else {
+
+            WRENCH_INFO("Starting the first level!");
 
-        placeholder_jobs = createPlaceHolderJobsForLevel(level_to_submit);
+        }
 
-        // TODO - Must calculate leeway
         // Submit placeholder jobs
-        for (auto ph : placeholder_jobs) {
-            new_ongoing_level->pending_placeholder_jobs.insert(ph);
+        for (auto ph : new_ongoing_level->pending_placeholder_jobs) {
 
-            // Create the pilot job
-            double makespan = ph->clustered_job->estimateMakespan(this->core_speed) * EXECUTION_TIME_FUDGE_FACTOR;
+            // Ask for the time until the inputs are ready on top of the makespan
+            double leeway = std::max<double>(0, inputs_ready_date - predicted_start_dates[ph]);
+            double makespan = makespans[ph] *
+                              WorkflowUtil::getWalltimeFactor(ph->clustered_job->getTasks(),
+                                                              ph->clustered_job->getNumNodes(), this->core_speed) +
+                              leeway;
+            new_ongoing_level->predicted_end_dates[ph] =
+                    std::max<double>(predicted_start_dates[ph], inputs_ready_date) + makespans[ph];
 
             // Create the pilot job
             ph->pilot_job = this->job_manager->createPilotJob();
@@ -175,6 +229,47 @@ namespace wrench {
         }
 
         ongoing_levels.insert(std::make_pair(level_to_submit, new_ongoing_level));
+        this->next_level = nullptr;
+    }
+
+    /**
+     * @brief Predict when pilot jobs would start if they were submitted now, using the batch service's
+     *        start time estimates
+     * @param placeholder_jobs: the placeholder jobs
+     * @param makespans: the estimated makespan of each placeholder job
+     * @return the predicted start date of each placeholder job
+     */
+    std::map<PlaceHolderJob *, double>
+    LevelByLevelWMS::estimateStartDates(std::set<PlaceHolderJob *> placeholder_jobs,
+                                        std::map<PlaceHolderJob *, double> makespans) {
+        std::set<std::tuple<std::string, unsigned long, unsigned long, double>> job_configurations;
+        std::map<std::string, PlaceHolderJob *> job_ids;
+        for (auto ph : placeholder_jobs) {
+            std::string job_id = "level_by_level_tentative_job_" + std::to_string(Simulator::sequence_number++);
+            double walltime = makespans[ph] * WorkflowUtil::getWalltimeFactor(ph->clustered_job->getTasks(),
+                                                                              ph->clustered_job->getNumNodes(),
+                                                                              this->core_speed);
+            job_configurations.insert(std::make_tuple(job_id, ph->clustered_job->getNumNodes(), 1, walltime));
+            job_ids[job_id] = ph;
+        }
+
+        std::map<std::string, double> estimates;
+        try {
+            estimates = this->batch_service->getStartTimeEstimates(job_configurations);
+        } catch (WorkflowExecutionException &e) {
+            throw std::runtime_error(std::string("Couldn't acquire queue wait time predictions: ") + e.what());
+        }
+
+        double now = this->simulation->getCurrentSimulatedDate();
+        std::map<PlaceHolderJob *, double> start_dates;
+        for (auto const &job_id : job_ids) {
+            auto estimate = estimates.find(job_id.first);
+            if ((estimate == estimates.end()) or (estimate->second < 0)) {
+                throw std::runtime_error("Could not obtain start time estimate... aborting");
+            }
+            start_dates[job_id.second] = std::max<double>(now, estimate->second);
+        }
+        return start_dates;
     }
 
 
@@ -348,6 +443,17 @@ namespace wrench {
         }
 
 
+        // Release the nodes that run out of work early by using narrower, longer pilot jobs for the tail
+        if (Globals::max_staggered_jobs > 1) {
+            std::set<ClusteredJob *> staggered_jobs;
+            for (auto cj : clustered_jobs) {
+                for (auto staggered_job : cj->getStaggeredJobs(this->core_speed, Globals::max_staggered_jobs)) {
+                    staggered_jobs.insert(staggered_job);
+                }
+            }
+            clustered_jobs = staggered_jobs;
+        }
+
         /** Transform clustered jobs into PlaceHolderJobs */
         std::set<PlaceHolderJob *> place_holder_jobs;
         for (auto cj : clustered_jobs) {
@@ -402,18 +508,27 @@ namespace wrench {
         ongoing_level->pending_placeholder_jobs.erase(placeholder_job);
         ongoing_level->running_placeholder_jobs.insert(placeholder_job);
 
-        // Submit all ready tasks to it each in its standard job
-        std::string output_string = "";
-        for (auto task : placeholder_job->clustered_job->getTasks()) {
-            if (task->getState() == WorkflowTask::READY) {
-                auto standard_job = this->job_manager->createStandardJob(task, {});
-                output_string += " " + task->getID();
+        // Its tasks can only start when the previous level is done
+        double inputs_ready_date = this->simulation->getCurrentSimulatedDate();
+        auto previous_level = this->ongoing_levels.find(ongoing_level->level_number - 1);
+        if ((ongoing_level->level_number > 0) and (previous_level != this->ongoing_levels.end())) {
+            inputs_ready_date = std::max<double>(inputs_ready_date,
+                                                 previous_level->second->getPredictedCompletionDate());
+        }
+        ongoing_level->predicted_end_dates[placeholder_job] =
+                inputs_ready_date + placeholder_job->clustered_job->estimateMakespan(this->core_speed);
 
-                WRENCH_INFO("Submitting task %s as part of placeholder job %ld-%ld",
-                            task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
-            } else { WRENCH_INFO("Task %s is not ready", task->getID().c_str());
-            }
+        // Submit all ready tasks to it each in its standard job
+        placeholder_job->start_date = this->simulation->getCurrentSimulatedDate();
+        placeholder_job->initializeReadyTasks();
+        WorkflowTask *task;
+        while ((task = placeholder_job->popReadyTask()) != nullptr) {
+            auto standard_job = this->job_manager->createStandardJob(task, {});
+
+            WRENCH_INFO("Submitting task %s as part of placeholder job %ld-%ld",
+                        task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
+            this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
+            placeholder_job->num_standard_job_submitted++;
         }
 
     }
@@ -451,13 +566,7 @@ namespace wrench {
 //               placeholder_job->pilot_job->getName().c_str());
 
         // Check if there are unprocessed tasks
-        bool unprocessed = false;
-        for (auto t : placeholder_job->clustered_job->getTasks()) {
-            if (t->getState() != WorkflowTask::COMPLETED) {
-                unprocessed = true;
-                break;
-            }
-        }
+        bool unprocessed = placeholder_job->hasUnprocessedTasks();
 
 //      double wasted_node_seconds = e->pilot_job->getNumHosts() * e->pilot_job->getDuration();
         ulong num_used_nodes;
@@ -467,7 +576,7 @@ namespace wrench {
         double wasted_node_seconds = 60.0 * num_used_minutes * num_used_nodes;
         
         double used_seconds = 0;
-        for (auto t : placeholder_job->clustered_job->getTasks()) {
+        for (auto t : placeholder_job->getExecutedTasks()) {
             if (t->getState() == WorkflowTask::COMPLETED) {
                 wasted_node_seconds -= t->getFlops() / this->core_speed;
                 used_seconds += t->getFlops() / this->core_speed;
@@ -476,6 +585,17 @@ namespace wrench {
 
         this->simulator->wasted_node_seconds += wasted_node_seconds;
 
+        // The tasks it took from other placeholder jobs and didn't complete go back to them
+        std::vector<WorkflowTask *> stolen_tasks_to_return;
+        for (auto const &stolen_task : placeholder_job->stolen_tasks) {
+            if (stolen_task.first->getState() != WorkflowTask::COMPLETED) {
+                stolen_tasks_to_return.push_back(stolen_task.first);
+            }
+        }
+        for (auto t : stolen_tasks_to_return) {
+            this->giveBackStolenTask(placeholder_job, t);
+        }
+
         if (not unprocessed) { // Nothing to do
             WRENCH_INFO("This placeholder job has no unprocessed tasks. great.");
             return;
@@ -514,7 +634,8 @@ namespace wrench {
             cj->setNumNodes(num_nodes, true);
         }
 
-        double makespan = cj->estimateMakespan(this->core_speed) * EXECUTION_TIME_FUDGE_FACTOR;
+        double makespan = cj->estimateMakespan(this->core_speed) *
+                          WorkflowUtil::getWalltimeFactor(cj->getTasks(), cj->getNumNodes(), this->core_speed);
 
         // Create the pilot job
         auto pj = this->job_manager->createPilotJob();
@@ -554,17 +675,27 @@ namespace wrench {
 
         this->simulator->used_node_seconds += completed_task->getFlops() / this->core_speed;
 
-        // Find the placeholder job this task belongs to
+        // Find the placeholder job this task belongs to (which may not have started if the task was stolen),
+        // and the one it ran in if it was stolen
         PlaceHolderJob *placeholder_job = nullptr;
         OngoingLevel *ongoing_level = nullptr;
+        PlaceHolderJob *host_placeholder_job = nullptr;
+        OngoingLevel *host_ongoing_level = nullptr;
         for (auto ol : this->ongoing_levels) {
             for (auto ph : ol.second->running_placeholder_jobs) {
-                for (auto task : ph->clustered_job->getTasks()) {
-                    if (task == completed_task) {
-                        ongoing_level = ol.second;
-                        placeholder_job = ph;
-                        break;
-                    }
+                if (ph->hasTask(completed_task)) {
+                    ongoing_level = ol.second;
+                    placeholder_job = ph;
+                }
+                if (ph->stolen_tasks.find(completed_task) != ph->stolen_tasks.end()) {
+                    host_ongoing_level = ol.second;
+                    host_placeholder_job = ph;
+                }
+            }
+            for (auto ph : ol.second->pending_placeholder_jobs) {
+                if (ph->hasTask(completed_task)) {
+                    ongoing_level = ol.second;
+                    placeholder_job = ph;
                 }
             }
         }
@@ -574,43 +705,71 @@ namespace wrench {
                                      "and we're not in individual mode");
         }
 
-        // Terminate the pilot job in case all its tasks are done
-        bool all_tasks_done = true;
-        for (auto task : placeholder_job->clustered_job->getTasks()) {
-            if (task->getState() != WorkflowTask::COMPLETED) {
-                all_tasks_done = false;
-                break;
-            }
+        if (host_placeholder_job != nullptr) {
+            host_placeholder_job->num_standard_job_submitted--;
+        } else {
+            placeholder_job->num_standard_job_submitted--;
         }
-        if (all_tasks_done) {
-
-            // Update the wasted no seconds metric
-//        double wasted_node_seconds = placeholder_job->pilot_job->getNumHosts() * placeholder_job->pilot_job->getDuration();
-            ulong num_used_nodes;
-            sscanf(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"].c_str(), "%lu", &num_used_nodes);
-            ulong num_used_minutes;
-            sscanf(placeholder_job->pilot_job->getServiceSpecificArguments()["-t"].c_str(), "%lu", &num_used_minutes);
-            double wasted_node_seconds = 60.0 * num_used_minutes * num_used_nodes;
-
-            for (auto t : placeholder_job->clustered_job->getTasks()) {
-                if (t->getState() == WorkflowTask::COMPLETED) {
-                    wasted_node_seconds -= t->getFlops() / this->core_speed;
-                }
-            }
-            this->simulator->wasted_node_seconds += wasted_node_seconds;
+        placeholder_job->markTaskCompleted(completed_task);
 
-
-            WRENCH_INFO("All tasks are completed in this placeholder job, so I am terminating it (%s)",
+        // Cancel the pilot job if it hasn't started and all its tasks were run by others
+        if ((ongoing_level->pending_placeholder_jobs.find(placeholder_job) !=
+             ongoing_level->pending_placeholder_jobs.end()) and placeholder_job->areAllTasksCompleted()) {
+            WRENCH_INFO("All tasks of this pending placeholder job were run by others, so I am canceling it (%s)",
                         placeholder_job->pilot_job->getName().c_str());
             try {
                 this->job_manager->terminateJob(placeholder_job->pilot_job);
             } catch (WorkflowExecutionException &e) {
                 // ignore
             }
-            ongoing_level->running_placeholder_jobs.erase(placeholder_job);
+            ongoing_level->pending_placeholder_jobs.erase(placeholder_job);
             ongoing_level->completed_placeholder_jobs.insert(placeholder_job);
-            // TODO - this isn't removing from this->ongoing_levels???
-//            std::cout << "Finished all jobs in a placeholder!" << std::endl;
+        }
+
+        // Terminate the pilot jobs in case all their tasks are done
+        if ((ongoing_level->running_placeholder_jobs.find(placeholder_job) !=
+             ongoing_level->running_placeholder_jobs.end()) and placeholder_job->isDone()) {
+            this->terminatePlaceholderJob(placeholder_job, ongoing_level);
+        }
+        if ((host_placeholder_job != nullptr) and host_placeholder_job->isDone()) {
+            this->terminatePlaceholderJob(host_placeholder_job, host_ongoing_level);
+        }
+
+        // With overlap, submit the tasks that the completion made ready to the running placeholder jobs they are in
+        if (this->overlap) {
+            for (auto child : this->getWorkflow()->getTaskChildren(completed_task)) {
+                if (child->getState() != WorkflowTask::READY) {
+                    continue;
+                }
+                for (auto ol : this->ongoing_levels) {
+                    for (auto ph : ol.second->running_placeholder_jobs) {
+                        if (ph->hasTask(child)) {
+                            auto standard_job = this->job_manager->createStandardJob(child, {});
+                            WRENCH_INFO("Submitting task %s as part of placeholder job %ld-%ld",
+                                        child->getID().c_str(), ph->start_level, ph->end_level);
+                            this->job_manager->submitJob(standard_job, ph->pilot_job->getComputeService());
+                            ph->num_standard_job_submitted++;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Queue the tasks that the completion made ready in the pending placeholder jobs they are in, whose
+        // ready tasks running placeholder jobs can take
+        if (Globals::work_stealing) {
+            for (auto child : this->getWorkflow()->getTaskChildren(completed_task)) {
+                if (child->getState() != WorkflowTask::READY) {
+                    continue;
+                }
+                for (auto ol : this->ongoing_levels) {
+                    for (auto ph : ol.second->pending_placeholder_jobs) {
+                        if (ph->hasTask(child)) {
+                            ph->enqueueReadyTask(child);
+                        }
+                    }
+                }
+            }
         }
 
         /**
@@ -634,21 +793,126 @@ namespace wrench {
         }
         */
 
-        // Remove the ongoing level if it's finished
-        if (ongoing_level->pending_placeholder_jobs.empty() and
-            ongoing_level->running_placeholder_jobs.empty()) {
+        // Remove the ongoing levels if they're finished
+        for (auto ol : {ongoing_level, host_ongoing_level}) {
+            if ((ol == nullptr) or (this->ongoing_levels.find(ol->level_number) == this->ongoing_levels.end())) {
+                continue;
+            }
+            if (ol->pending_placeholder_jobs.empty() and
+                ol->running_placeholder_jobs.empty()) {
 
-            WRENCH_INFO("Level %ld is finished!", ongoing_level->level_number);
+                WRENCH_INFO("Level %ld is finished!", ol->level_number);
 
-//            printf("Level %ld is finished!\n", ongoing_level->level_number);
-            this->last_level_completed = ongoing_level->level_number;
+//            printf("Level %ld is finished!\n", ol->level_number);
+                if ((this->last_level_completed == ULONG_MAX) or (this->last_level_completed < ol->level_number)) {
+                    this->last_level_completed = ol->level_number;
+                }
 
-            this->ongoing_levels.erase(ongoing_level->level_number);
+                this->ongoing_levels.erase(ol->level_number);
+            }
         }
 
     }
 
+    /**
+     * @brief Terminate a running placeholder job whose tasks are all done, and account for its wasted node time
+     * @param placeholder_job: a running placeholder job
+     * @param ongoing_level: the ongoing level the placeholder job is part of
+     */
+    void LevelByLevelWMS::terminatePlaceholderJob(PlaceHolderJob *placeholder_job, OngoingLevel *ongoing_level) {
+
+        // Update the wasted no seconds metric
+//        double wasted_node_seconds = placeholder_job->pilot_job->getNumHosts() * placeholder_job->pilot_job->getDuration();
+        ulong num_used_nodes;
+        sscanf(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"].c_str(), "%lu", &num_used_nodes);
+        ulong num_used_minutes;
+        sscanf(placeholder_job->pilot_job->getServiceSpecificArguments()["-t"].c_str(), "%lu", &num_used_minutes);
+        double wasted_node_seconds = 60.0 * num_used_minutes * num_used_nodes;
+
+        for (auto t : placeholder_job->getExecutedTasks()) {
+            if (t->getState() == WorkflowTask::COMPLETED) {
+                wasted_node_seconds -= t->getFlops() / this->core_speed;
+            }
+        }
+        this->simulator->wasted_node_seconds += wasted_node_seconds;
+
+
+        WRENCH_INFO("All tasks are completed in this placeholder job, so I am terminating it (%s)",
+                    placeholder_job->pilot_job->getName().c_str());
+        try {
+            this->job_manager->terminateJob(placeholder_job->pilot_job);
+        } catch (WorkflowExecutionException &e) {
+            // ignore
+        }
+        ongoing_level->running_placeholder_jobs.erase(placeholder_job);
+        ongoing_level->completed_placeholder_jobs.insert(placeholder_job);
+        // TODO - this isn't removing from this->ongoing_levels???
+    }
+
+    /**
+     * @brief Submit ready tasks of the placeholder jobs that haven't started yet to the idle hosts of
+     *        the running ones
+     */
+    void LevelByLevelWMS::dispatchStolenTasks() {
+        for (auto host_ol : this->ongoing_levels) {
+            for (auto ph : host_ol.second->running_placeholder_jobs) {
+                for (auto victim_ol : this->ongoing_levels) {
+                    for (auto victim : victim_ol.second->pending_placeholder_jobs) {
+                        while (ph->num_standard_job_submitted < ph->getNumSlots()) {
+                            WorkflowTask *task = ph->stealReadyTask(victim, this->simulation->getCurrentSimulatedDate(),
+                                                                    this->core_speed);
+                            if (task == nullptr) {
+                                break;
+                            }
+
+                            auto standard_job = this->job_manager->createStandardJob(task, {});
+                            WRENCH_INFO("Submitting task %s of a pending placeholder job as part of placeholder job %ld-%ld",
+                                        task->getID().c_str(), ph->start_level, ph->end_level);
+                            this->job_manager->submitJob(standard_job, ph->pilot_job->getComputeService());
+                            ph->num_standard_job_submitted++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Give a stolen task that couldn't complete back to the placeholder job it belongs to, and
+     *        submit it there if that placeholder job is already running
+     * @param placeholder_job: the placeholder job the task was stolen by
+     * @param task: the task
+     * @return true if the task was stolen, false otherwise
+     */
+    bool LevelByLevelWMS::giveBackStolenTask(PlaceHolderJob *placeholder_job, WorkflowTask *task) {
+        PlaceHolderJob *owner = placeholder_job->returnStolenTask(task);
+        if (owner == nullptr) {
+            return false;
+        }
+        placeholder_job->num_standard_job_submitted--;
+
+        // The task is back in the owner's ready queue: a pending owner will submit it when its pilot job starts
+        if (owner->start_date >= 0) {
+            WorkflowTask *ready_task;
+            while ((ready_task = owner->popReadyTask()) != nullptr) {
+                auto standard_job = this->job_manager->createStandardJob(ready_task, {});
+                WRENCH_INFO("Submitting stolen task %s back as part of placeholder job %ld-%ld",
+                            ready_task->getID().c_str(), owner->start_level, owner->end_level);
+                this->job_manager->submitJob(standard_job, owner->pilot_job->getComputeService());
+                owner->num_standard_job_submitted++;
+            }
+        }
+        return true;
+    }
+
     void LevelByLevelWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> e) {
+        for (auto ol : this->ongoing_levels) {
+            for (auto ph : ol.second->running_placeholder_jobs) {
+                if (this->giveBackStolenTask(ph, e->standard_job->tasks[0])) {
+                    return;
+                }
+            }
+        }
         WRENCH_INFO(
                 "Got a standard job failure event for task %s -- IGNORING THIS (the pilot job expiration event will handle these issues)",
                 e->standard_job->tasks[0]->getID().c_str());
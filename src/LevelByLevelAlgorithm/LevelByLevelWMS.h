@@ -25,7 +25,8 @@ namespace wrench {
     public:
 
         LevelByLevelWMS(Simulator *simulator, std::string hostname, bool overlap,
-                std::string clustering_spec, std::shared_ptr<BatchComputeService> batch_service);
+                std::string clustering_spec, std::shared_ptr<BatchComputeService> batch_service,
+                unsigned long lookahead_depth = 2, bool timed_submissions = false);
 
 
     private:
@@ -40,6 +41,15 @@ namespace wrench {
 
         std::set<PlaceHolderJob *> createPlaceHolderJobsForLevel(unsigned long level);
 
+        std::map<PlaceHolderJob *, double> estimateStartDates(std::set<PlaceHolderJob *> placeholder_jobs,
+                                                              std::map<PlaceHolderJob *, double> makespans);
+
+        void terminatePlaceholderJob(PlaceHolderJob *placeholder_job, OngoingLevel *ongoing_level);
+
+        void dispatchStolenTasks();
+
+        bool giveBackStolenTask(PlaceHolderJob *placeholder_job, WorkflowTask *task);
+
 //        unsigned long computeBestNumNodesBasedOnQueueWaitTimePredictions(ClusteredJob *cj);
 
         Simulator *simulator;
@@ -48,6 +58,17 @@ namespace wrench {
         std::string clustering_spec;
         std::shared_ptr<BatchComputeService> batch_service;
 
+        // Maximum number of levels with pilot jobs in the system
+        unsigned long lookahead_depth;
+
+        // Whether a level is submitted when its pilot jobs are predicted to start as the previous level completes,
+        // rather than when the previous level's pilot jobs have all started
+        bool timed_submissions;
+
+        // The next level to submit, if its submission was deferred, and when to submit it
+        OngoingLevel *next_level;
+        double next_submission_date;
+
 
         double core_speed;
         unsigned long number_of_nodes;
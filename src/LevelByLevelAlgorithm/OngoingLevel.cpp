@@ -8,8 +8,21 @@
  */
 
 
+#include <algorithm>
 #include "OngoingLevel.h"
 
 namespace wrench {
 
+    /**
+     * @brief Get the predicted date at which all the tasks of the level are done
+     * @return a date (0 if no pilot job was submitted)
+     */
+    double OngoingLevel::getPredictedCompletionDate() {
+        double completion_date = 0;
+        for (auto const &end_date : this->predicted_end_dates) {
+            completion_date = std::max<double>(completion_date, end_date.second);
+        }
+        return completion_date;
+    }
+
 };
\ No newline at end of file
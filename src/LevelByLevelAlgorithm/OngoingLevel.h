@@ -13,6 +13,7 @@
 
 
 #include <set>
+#include <map>
 #include <Util/PlaceHolderJob.h>
 
 namespace wrench {
@@ -27,6 +28,11 @@ namespace wrench {
         std::set<PlaceHolderJob *> running_placeholder_jobs;
         std::set<PlaceHolderJob *> completed_placeholder_jobs;
 
+        // Predicted date at which each placeholder job's tasks are done
+        std::map<PlaceHolderJob *, double> predicted_end_dates;
+
+        double getPredictedCompletionDate();
+
     };
 
 };
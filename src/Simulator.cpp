@@ -23,9 +23,32 @@ using namespace wrench;
 unsigned long Simulator::sequence_number = 0;
 
 nlohmann::json Globals::sim_json;
+unsigned long Globals::num_threads = 1;
+double Globals::grouping_budget = 0;
+double Globals::runtime_cv = 0;
+unsigned long Globals::runtime_seed = 0;
+double Globals::expiration_probability = 0;
+bool Globals::export_pareto_fronts = false;
+bool Globals::work_stealing = false;
+unsigned long Globals::max_staggered_jobs = 1;
+unsigned long Globals::max_job_array_size = 1;
+double Globals::replan_margin = 0;
+bool Globals::static_lookahead = false;
+std::string Globals::plan_file = "";
+double Globals::staging_bandwidth = 0;
+double Globals::pareto_weight = -1;
+unsigned long Globals::num_pruned_makespan_estimates = 0;
+unsigned long Globals::num_pruned_wait_time_estimates = 0;
+unsigned long Globals::num_pruned_splits = 0;
+unsigned long Globals::num_coalesced_events = 0;
+unsigned long Globals::num_job_arrays = 0;
+unsigned long Globals::num_job_array_elements = 0;
 
 int Simulator::main(int argc, char **argv) {
 
+    // Remove the simulator's own options before WRENCH/SimGrid see the command line
+    parseOptions(&argc, argv);
+
     // Create and initialize a simulation
     auto simulation = new wrench::Simulation();
     simulation->init(&argc, argv);
@@ -33,7 +56,7 @@ int Simulator::main(int argc, char **argv) {
     // Parse command-line arguments
     if ((argc != 9) and (argc != 10)) {
         std::cerr << "\e[1;31mUsage: " << argv[0]
-                  << " <num_compute_nodes> <job trace file> <real|fake> <max jobs in system> <workflow specification> <workflow start time> <algorithm> <batch algorithm> [DISABLED: csv batch log file] [OPTIONAL: json result file]\e[0m"
+                  << " <num_compute_nodes> <job trace file> <real|fake> <max jobs in system> <workflow specification> <workflow start time> <algorithm> <batch algorithm> [DISABLED: csv batch log file] [OPTIONAL: json result file] [--option=value ...]\e[0m"
                   << "\n";
         std::cerr << "  \e[1;32m### workflow specification options ###\e[0m" << "\n";
         std::cerr << "    *  \e[1mindep:s:n:t1:t2\e[0m " << "\n";
@@ -49,12 +72,31 @@ int Simulator::main(int argc, char **argv) {
         std::cerr << "      - tx/Tx: min/max task durations in level x, in integral second (times uniformly sampled)"
                   << "\n";
         std::cerr << "      - s: rng seed" << "\n";
+        std::cerr << "    * \e[1mforkjoin:s:k:w:d\e[0m" << "\n";
+        std::cerr << "      - k stages of w parallel tasks, each between a fork task and a join task" << "\n";
+        std::cerr << "      - d: task duration distribution (see below)" << "\n";
+        std::cerr << "      - s: rng seed" << "\n";
+        std::cerr << "    * \e[1mlayered:s:l:w:p:d\e[0m" << "\n";
+        std::cerr << "      - l layers of w tasks, each depending on each task of the previous layer with probability p" << "\n";
+        std::cerr << "        (and on at least one of them)" << "\n";
+        std::cerr << "      - d: task duration distribution (see below)" << "\n";
+        std::cerr << "      - s: rng seed" << "\n";
+        std::cerr << "    * \e[1mmontage:s:n:d\e[0m" << "\n";
+        std::cerr << "      - A Montage-like workflow for a mosaic of n tiles" << "\n";
+        std::cerr << "    * \e[1mepigenomics:s:b:n:d\e[0m" << "\n";
+        std::cerr << "      - An Epigenomics-like workflow with b lanes, each split into n chunks" << "\n";
+        std::cerr << "    * \e[1mcybershake:s:e:n:d\e[0m" << "\n";
+        std::cerr << "      - A CyberShake-like workflow with e SGT extractions, each followed by n seismogram syntheses" << "\n";
+        std::cerr << "    * task duration distributions d of the synthetic workflows above:" << "\n";
+        std::cerr << "      - u-t1-t2: integral seconds uniformly sampled between t1 and t2" << "\n";
+        std::cerr << "      - lognormal-m-cv: log-normal with mean m seconds and coefficient of variation cv" << "\n";
+        std::cerr << "      - pareto-m-a: Pareto with minimum m seconds and shape a" << "\n";
         std::cerr << "    * \e[1mdax:filename\e[0m" << "\n";
         std::cerr << "      - A workflow imported from a DAX file" << "\n";
-        std::cerr << "      - Files and Data dependencies are ignored. Only control dependencies are preserved" << "\n";
+        std::cerr << "      - Only control dependencies are preserved; files are only used to model staging" << "\n";
         std::cerr << "    * \e[1mjson:filename\e[0m" << "\n";
         std::cerr << "      - A workflow imported from a JSON file" << "\n";
-        std::cerr << "      - Files and Data dependencies are ignored. Only control dependencies are preserved" << "\n";
+        std::cerr << "      - Only control dependencies are preserved; files are only used to model staging" << "\n";
         std::cerr << "\n";
         std::cerr << "  \e[1;32m### algorithm options ###\e[0m" << "\n";
         std::cerr << "    * \e[1mstatic:levelbylevel-m\e[0m" << "\n";
@@ -92,6 +134,25 @@ int Simulator::main(int argc, char **argv) {
         std::cerr << "      - [vprior|vposterior|vnone]: application of vertical clustering" << "\n";
         std::cerr << "      - t: bound on runtime (in seconds)" << "\n";
         std::cerr << "      - m: number of hosts used to execute each cluster" << "\n";
+        std::cerr << "              - if m = 0, then pick best number nodes based on queue wait time prediction"
+                  << "\n";
+        std::cerr << "    * \e[1mstatic:dfjs_bfd-[vprior|vposterior|vnone]-t-m\e[0m" << "\n";
+        std::cerr << "      - Same as dfjs, but tasks in each level are packed longest first, each in the cluster it fits" << "\n";
+        std::cerr << "        best, with each cluster seen as m hosts that can each run tasks for t seconds" << "\n";
+        std::cerr << "        (each cluster is then checked with the makespan estimate of dfjs, and split if it exceeds t)" << "\n";
+        std::cerr << "      - [vprior|vposterior|vnone]: application of vertical clustering" << "\n";
+        std::cerr << "      - t: bound on runtime (in seconds)" << "\n";
+        std::cerr << "      - m: number of hosts used to execute each cluster" << "\n";
+        std::cerr << "              - if m = 0, then pick best number nodes based on queue wait time prediction"
+                  << "\n";
+        std::cerr << "    * \e[1mstatic:locality-[vprior|vposterior|vnone]-t-m\e[0m" << "\n";
+        std::cerr << "      - Cluster tasks in each level so that tasks reading the same files are in the same cluster" << "\n";
+        std::cerr << "        (to stage fewer bytes with --staging-bandwidth), with each cluster seen as m hosts that" << "\n";
+        std::cerr << "        can each run tasks for t seconds (each cluster is then checked with the makespan estimate" << "\n";
+        std::cerr << "        of dfjs, which includes staging, and split if it exceeds t)" << "\n";
+        std::cerr << "      - [vprior|vposterior|vnone]: application of vertical clustering" << "\n";
+        std::cerr << "      - t: bound on runtime (in seconds)" << "\n";
+        std::cerr << "      - m: number of hosts used to execute each cluster" << "\n";
         std::cerr << "              - if m = 0, then pick best number nodes based on queue wait time prediction"
                   << "\n";
         std::cerr << "    * \e[1mstatic:hrb-[vprior|vposterior|vnone]-n-m\e[0m" << "\n";
@@ -136,12 +197,22 @@ int Simulator::main(int argc, char **argv) {
         std::cerr << "      - m: number of hosts used to execute each cluster" << "\n";
         std::cerr << "              - if m = 0, then pick best number nodes based on queue wait time prediction"
                   << "\n";
+        std::cerr << "    * \e[1mstatic:pcp-t-m\e[0m" << "\n";
+        std::cerr << "      - Cluster tasks along partial critical paths and the sub-DAGs around them, regardless of levels"
+                  << "\n";
+        std::cerr << "      - t: target makespan of each cluster, in seconds" << "\n";
+        std::cerr << "      - m: number of hosts used to execute each cluster" << "\n";
+        std::cerr << "              - if m = 0, then pick best number nodes based on queue wait time prediction"
+                  << "\n";
+        std::cerr << "    * \e[1mstatic:plan-file\e[0m" << "\n";
+        std::cerr << "      - Load the jobs computed by another static algorithm in a run with --export-plan=file," << "\n";
+        std::cerr << "        which must have used the same workflow (the file path can't contain ':')" << "\n";
         std::cerr << "    * \e[1mstatic:vc\e[0m" << "\n";
         std::cerr
                 << "      - The VC algorithm in \"Using Imbalance Metrics to Optimize Task Clustering in Scientific Workflow Executions\" by Chen at al."
                 << "\n";
         std::cerr << "      - Cluster tasks with single-parent-single-child depepdencies" << "\n";
-        std::cerr << "    * \e[1mzhang:[global|noglobal]:[bsearch|nobsearch]:[prediction|noprediction]\e[0m" << "\n";
+        std::cerr << "    * \e[1mzhang:[global|noglobal]:[bsearch|nobsearch]:[prediction|noprediction][:adaptive]\e[0m" << "\n";
         std::cerr << "      - The algorithm by Zhang, Koelbel, and Cooper + our improvements" << "\n";
         std::cerr << "      - [global|noglobal]: pick the globally best ratio; otherwise, greedily pick" << "\n";
         std::cerr
@@ -149,17 +220,28 @@ int Simulator::main(int argc, char **argv) {
                 << "\n";
         std::cerr << "      - [prediction|noprediction]: pick parallelism based on makespan+wait predictions"
                   << "\n";
-        std::cerr << "    * \e[1mglume:waste_bound:beat_bound\e[0m" << "\n";
+        std::cerr << "      - [adaptive]: calibrate the wait/run ratio that triggers individual mode with the ratios of"
+                  << "\n";
+        std::cerr << "        individual jobs, and go back to placeholder jobs if predicted faster when a task completion"
+                  << "\n";
+        std::cerr << "        ends a level"
+                  << "\n";
+        std::cerr << "    * \e[1mglume:waste_bound:beat_bound[:twoway|:multiway]\e[0m" << "\n";
         std::cerr << "      - GLUME: Group Levels Using Makespan Estimates" << "\n";
         std::cerr << "      - waste_bound: maximum percentage of wasted node time e.g. 0.2" << "\n";
         std::cerr
                 << "      - beat_bound: percentage splitting time must beat non-splitting time by to be viable e.g. 0.1"
                 << "\n";
-        std::cerr << "    * \e[1mlevelbylevel:[overlap|nooverlap]:levelclustering\e[0m" << "\n";
+        std::cerr << "      - [twoway|multiway]: split the remaining levels at most once (default), or plan the best" << "\n";
+        std::cerr << "        partition into any number of groups, each submitted when the previous one starts" << "\n";
+        std::cerr << "    * \e[1mlevelbylevel:[overlap|nooverlap]:levelclustering[:depth-k|:timed-k]\e[0m" << "\n";
         std::cerr << "        - A level-by-level-with overlap algorithm that clusters tasks in each level." << "\n";
         std::cerr << "          Tasks in level n+1 are submitted to the batch queue as soon as all tasks in level n"
                   << "\n";
         std::cerr << "          have started. Timout behavior similar as that in the algorithm by Zhang et al." << "\n";
+        std::cerr << "        - depth-k: with overlap, up to k levels have pilot jobs in the system (default: 2)" << "\n";
+        std::cerr << "        - timed-k: same, but level n+1 is submitted when its pilot jobs are predicted to start" << "\n";
+        std::cerr << "          as level n completes, based on queue wait time predictions" << "\n";
         std::cerr << "        - levelclustering: the algorithm used to cluster tasks in each level. Options are: "
                   << "\n";
         std::cerr << "          - one_job-m: the level is submitted as a single job" << "\n";
@@ -206,6 +288,59 @@ int Simulator::main(int argc, char **argv) {
         std::cerr << "    * \e[1mfcfs_fast\e[0m" << "\n";
         std::cerr << "      - first come, first serve" << "\n";
         std::cerr << "\n";
+        std::cerr << "  \e[1;32m### simulator options (anywhere on the command line) ###\e[0m" << "\n";
+        std::cerr << "    * \e[1m--threads=n\e[0m" << "\n";
+        std::cerr << "      - number of threads used to compute makespan estimates (default: 1)" << "\n";
+        std::cerr << "    * \e[1m--grouping-budget=seconds\e[0m" << "\n";
+        std::cerr << "      - CPU time allotted to each grouping decision of the glume and zhang algorithms, which then" << "\n";
+        std::cerr << "        look at the most promising candidates first (default: 0, i.e., no limit; the CPU time of" << "\n";
+        std::cerr << "        all threads counts, see --threads)" << "\n";
+        std::cerr << "    * \e[1m--runtime-cv=c\e[0m" << "\n";
+        std::cerr << "      - coefficient of variation of task runtimes: actual runtimes are lognormally sampled around" << "\n";
+        std::cerr << "        the specified ones, which algorithms use as estimates (default: 0, i.e., no variation)" << "\n";
+        std::cerr << "      - json workflows can override it for each job with a \"runtimeCV\" field" << "\n";
+        std::cerr << "    * \e[1m--runtime-seed=n\e[0m" << "\n";
+        std::cerr << "      - rng seed used to sample task runtimes (default: 0)" << "\n";
+        std::cerr << "    * \e[1m--expiration-probability=p\e[0m" << "\n";
+        std::cerr << "      - request job times so that each job expires with probability p, based on a Monte-Carlo" << "\n";
+        std::cerr << "        estimate of its makespan distribution (default: 0, i.e., use a fixed 1.5 factor)" << "\n";
+        std::cerr << "    * \e[1m--pareto-front\e[0m" << "\n";
+        std::cerr << "      - add to the json result file the non-dominated (finish time, node-seconds) candidates" << "\n";
+        std::cerr << "        of each number-of-nodes decision made with queue wait time predictions" << "\n";
+        std::cerr << "    * \e[1m--pareto-weight=w\e[0m" << "\n";
+        std::cerr << "      - pick numbers of nodes from these fronts, minimizing w * finish time + (1-w) * node-seconds" << "\n";
+        std::cerr << "        (each relative to its best value on the front), with w in [0,1]" << "\n";
+        std::cerr << "      - default: pick the earliest finish time" << "\n";
+        std::cerr << "    * \e[1m--work-stealing\e[0m" << "\n";
+        std::cerr << "      - with the zhang, glume and levelbylevel algorithms, run ready tasks of pilot jobs that" << "\n";
+        std::cerr << "        haven't started on idle hosts of running ones, if they fit in the remaining time" << "\n";
+        std::cerr << "    * \e[1m--staggered-jobs=n\e[0m" << "\n";
+        std::cerr << "      - with the static and levelbylevel algorithms, submit each job of independent tasks as up to n" << "\n";
+        std::cerr << "        jobs with different numbers of nodes and requested times, so that nodes that run out of" << "\n";
+        std::cerr << "        work early are released early; the json result file compares each split to the single" << "\n";
+        std::cerr << "        job (default: 1, i.e., no split)" << "\n";
+        std::cerr << "    * \e[1m--job-arrays=n\e[0m" << "\n";
+        std::cerr << "      - with static:one_job_per_task and the individual mode of the zhang algorithm, submit up to n" << "\n";
+        std::cerr << "        ready single-task jobs that request the same time as a job array, which counts as one" << "\n";
+        std::cerr << "        job in the system while each of its elements is scheduled on its own (default: 1)" << "\n";
+        std::cerr << "    * \e[1m--replan-margin=m\e[0m" << "\n";
+        std::cerr << "      - with the static hc, dfjs, dfjs_bfd, locality, hrb, hifb and hdb algorithms, re-cluster" << "\n";
+        std::cerr << "        the levels that haven't been submitted when a job completes after a queue wait that differed" << "\n";
+        std::cerr << "        from its prediction by more than m times the prediction, with larger clusters if waits are" << "\n";
+        std::cerr << "        longer (default: 0, i.e., never; not with --staging-bandwidth)" << "\n";
+        std::cerr << "    * \e[1m--staging-bandwidth=b\e[0m" << "\n";
+        std::cerr << "      - with dax and json workflows and the static algorithms, each job stages in the files its tasks" << "\n";
+        std::cerr << "        read that none of them writes, and stages out the files they write for other tasks or as" << "\n";
+        std::cerr << "        workflow outputs, at b MB/s, which is simulated as a stage-in task and a stage-out task in" << "\n";
+        std::cerr << "        each job, and included in makespan estimates (and so requested times); ignored by the other" << "\n";
+        std::cerr << "        algorithms, whose pilot jobs don't stage files (default: 0, i.e., no staging)" << "\n";
+        std::cerr << "    * \e[1m--static-lookahead\e[0m" << "\n";
+        std::cerr << "      - with the static algorithms, submit a job whose parents are running as a pilot job if its" << "\n";
+        std::cerr << "        predicted queue wait exceeds their remaining runtime, running its tasks as they become ready" << "\n";
+        std::cerr << "    * \e[1m--export-plan=file\e[0m" << "\n";
+        std::cerr << "      - with the static algorithms, write the computed jobs (tasks, numbers of hosts, waste bounds)" << "\n";
+        std::cerr << "        to file, for static:plan-file to reuse them without clustering again" << "\n";
+        std::cerr << "\n";
         exit(1);
     }
     unsigned long num_compute_nodes;
@@ -327,6 +462,9 @@ int Simulator::main(int argc, char **argv) {
     std::cout << "USED NODE SECONDS=" << this->used_node_seconds << "\n";
     std::cout << "WASTED NODE SECONDS=" << this->wasted_node_seconds << "\n";
     std::cout << "SIMULATION TIME=" << elapsed << "\n";
+    std::cout << "PRUNED ESTIMATES=" << Globals::num_pruned_makespan_estimates << " makespans, "
+              << Globals::num_pruned_wait_time_estimates << " wait times, "
+              << Globals::num_pruned_splits << " splits\n";
     std::cout << "CSV LOG FILE=" << csv_batch_log << "\n";
 
     if (argc == 10) {
@@ -348,6 +486,12 @@ int Simulator::main(int argc, char **argv) {
         Globals::sim_json["total_queue_wait"] = this->total_queue_wait_time;
         Globals::sim_json["used_node_sec"] = this->used_node_seconds;
         Globals::sim_json["wasted_node_seconds"] = this->wasted_node_seconds;
+        Globals::sim_json["pruned_makespan_estimates"] = Globals::num_pruned_makespan_estimates;
+        Globals::sim_json["pruned_wait_time_estimates"] = Globals::num_pruned_wait_time_estimates;
+        Globals::sim_json["pruned_splits"] = Globals::num_pruned_splits;
+        Globals::sim_json["coalesced_events"] = Globals::num_coalesced_events;
+        Globals::sim_json["num_job_arrays"] = Globals::num_job_arrays;
+        Globals::sim_json["num_job_array_elements"] = Globals::num_job_array_elements;
 
         // TODO - how to handle runtime errors
 
@@ -358,6 +502,94 @@ int Simulator::main(int argc, char **argv) {
     return 0;
 }
 
+/**
+ * @brief Remove the simulator's own --option=value arguments from the command line and store their values in Globals
+ * @param argc: the number of arguments (updated)
+ * @param argv: the arguments (updated)
+ */
+void Simulator::parseOptions(int *argc, char **argv) {
+    int num_arguments = 1;
+    for (int i = 1; i < *argc; i++) {
+        std::string argument = std::string(argv[i]);
+        if (argument.find("--threads=") == 0) {
+            if ((sscanf(argument.c_str(), "--threads=%lu", &Globals::num_threads) != 1) or
+                (Globals::num_threads < 1)) {
+                std::cerr << "Invalid number of threads\n";
+                exit(1);
+            }
+        } else if (argument.find("--grouping-budget=") == 0) {
+            if ((sscanf(argument.c_str(), "--grouping-budget=%lf", &Globals::grouping_budget) != 1) or
+                (Globals::grouping_budget < 0)) {
+                std::cerr << "Invalid grouping budget\n";
+                exit(1);
+            }
+        } else if (argument.find("--runtime-cv=") == 0) {
+            if ((sscanf(argument.c_str(), "--runtime-cv=%lf", &Globals::runtime_cv) != 1) or
+                (Globals::runtime_cv < 0)) {
+                std::cerr << "Invalid runtime coefficient of variation\n";
+                exit(1);
+            }
+        } else if (argument.find("--runtime-seed=") == 0) {
+            if (sscanf(argument.c_str(), "--runtime-seed=%lu", &Globals::runtime_seed) != 1) {
+                std::cerr << "Invalid runtime seed\n";
+                exit(1);
+            }
+        } else if (argument.find("--staggered-jobs=") == 0) {
+            if ((sscanf(argument.c_str(), "--staggered-jobs=%lu", &Globals::max_staggered_jobs) != 1) or
+                (Globals::max_staggered_jobs < 1)) {
+                std::cerr << "Invalid number of staggered jobs\n";
+                exit(1);
+            }
+        } else if (argument.find("--job-arrays=") == 0) {
+            if ((sscanf(argument.c_str(), "--job-arrays=%lu", &Globals::max_job_array_size) != 1) or
+                (Globals::max_job_array_size < 1)) {
+                std::cerr << "Invalid job array size\n";
+                exit(1);
+            }
+        } else if (argument.find("--replan-margin=") == 0) {
+            if ((sscanf(argument.c_str(), "--replan-margin=%lf", &Globals::replan_margin) != 1) or
+                (Globals::replan_margin < 0)) {
+                std::cerr << "Invalid re-planning margin\n";
+                exit(1);
+            }
+        } else if (argument.find("--staging-bandwidth=") == 0) {
+            if ((sscanf(argument.c_str(), "--staging-bandwidth=%lf", &Globals::staging_bandwidth) != 1) or
+                (Globals::staging_bandwidth < 0)) {
+                std::cerr << "Invalid staging bandwidth\n";
+                exit(1);
+            }
+            Globals::staging_bandwidth *= 1000.0 * 1000.0;
+        } else if (argument.find("--export-plan=") == 0) {
+            Globals::plan_file = argument.substr(std::string("--export-plan=").length());
+            if (Globals::plan_file.empty()) {
+                std::cerr << "Invalid plan file\n";
+                exit(1);
+            }
+        } else if (argument == "--static-lookahead") {
+            Globals::static_lookahead = true;
+        } else if (argument == "--work-stealing") {
+            Globals::work_stealing = true;
+        } else if (argument == "--pareto-front") {
+            Globals::export_pareto_fronts = true;
+        } else if (argument.find("--pareto-weight=") == 0) {
+            if ((sscanf(argument.c_str(), "--pareto-weight=%lf", &Globals::pareto_weight) != 1) or
+                (Globals::pareto_weight < 0) or (Globals::pareto_weight > 1)) {
+                std::cerr << "Invalid Pareto weight\n";
+                exit(1);
+            }
+        } else if (argument.find("--expiration-probability=") == 0) {
+            if ((sscanf(argument.c_str(), "--expiration-probability=%lf", &Globals::expiration_probability) != 1) or
+                (Globals::expiration_probability <= 0) or (Globals::expiration_probability >= 1)) {
+                std::cerr << "Invalid expiration probability\n";
+                exit(1);
+            }
+        } else {
+            argv[num_arguments++] = argv[i];
+        }
+    }
+    *argc = num_arguments;
+}
+
 void Simulator::setupSimulationPlatform(Simulation *simulation, unsigned long num_compute_nodes) {
 
     // Create a the platform file
@@ -426,6 +658,36 @@ Workflow *Simulator::createWorkflow(std::string workflow_spec) {
             throw;
         }
 
+    } else if (tokens[0] == "forkjoin") {
+        if (tokens.size() != 5) {
+            throw std::invalid_argument("createWorkflow(): Invalid workflow specification " + workflow_spec);
+        }
+        return createForkJoinWorkflow(tokens);
+
+    } else if (tokens[0] == "layered") {
+        if (tokens.size() != 6) {
+            throw std::invalid_argument("createWorkflow(): Invalid workflow specification " + workflow_spec);
+        }
+        return createLayeredWorkflow(tokens);
+
+    } else if (tokens[0] == "montage") {
+        if (tokens.size() != 4) {
+            throw std::invalid_argument("createWorkflow(): Invalid workflow specification " + workflow_spec);
+        }
+        return createMontageWorkflow(tokens);
+
+    } else if (tokens[0] == "epigenomics") {
+        if (tokens.size() != 5) {
+            throw std::invalid_argument("createWorkflow(): Invalid workflow specification " + workflow_spec);
+        }
+        return createEpigenomicsWorkflow(tokens);
+
+    } else if (tokens[0] == "cybershake") {
+        if (tokens.size() != 5) {
+            throw std::invalid_argument("createWorkflow(): Invalid workflow specification " + workflow_spec);
+        }
+        return createCyberShakeWorkflow(tokens);
+
     } else if (tokens[0] == "dax") {
         if (tokens.size() != 2) {
             throw std::invalid_argument("createWorkflow(): Invalid workflow specification " + workflow_spec);
@@ -450,12 +712,32 @@ Workflow *Simulator::createWorkflow(std::string workflow_spec) {
     }
 }
 
+/**
+ * @brief Add a task whose actual flops are sampled around its nominal flops
+ * @param workflow: the workflow
+ * @param id: the task's id
+ * @param nominal_flops: the task's nominal flops, which algorithms use as estimates
+ * @param cv: the coefficient of variation of the task's actual flops
+ * @param runtime_rng: the engine that samples the actual flops of the workflow's tasks, seeded with
+ *        Globals::runtime_seed when the workflow is created (and separate from the engine that generates a
+ *        synthetic workflow, so that the seed of the runtimes doesn't change the workflow)
+ * @return the task
+ */
+WorkflowTask *Simulator::addWorkflowTask(Workflow *workflow, std::string id, double nominal_flops, double cv,
+                                         std::default_random_engine &runtime_rng) {
+    double flops = WorkflowUtil::sampleFlops(nominal_flops, cv, runtime_rng);
+    WorkflowTask *task = workflow->addTask(id, flops, 1, 1, 1.0);
+    WorkflowUtil::setRuntimeModel(task, nominal_flops, cv);
+    return task;
+}
+
 Workflow *Simulator::createIndepWorkflow(std::vector<std::string> spec_tokens) {
     unsigned int seed;
     if (sscanf(spec_tokens[1].c_str(), "%u", &seed) != 1) {
         throw std::invalid_argument("createIndepWorkflow(): invalid RNG ssed in workflow specification");
     }
     std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
 
     unsigned long num_tasks;
     unsigned long min_time;
@@ -473,10 +755,11 @@ Workflow *Simulator::createIndepWorkflow(std::vector<std::string> spec_tokens) {
 
     auto workflow = new Workflow();
 
-    static std::uniform_int_distribution<unsigned long> m_udist(min_time, max_time);
+    std::uniform_int_distribution<unsigned long> m_udist(min_time, max_time);
     for (unsigned long i = 0; i < num_tasks; i++) {
         unsigned long flops = m_udist(rng);
-        auto t = workflow->addTask("Task_" + std::to_string(i), (double) flops, 1, 1, 1.0);
+        auto t = addWorkflowTask(workflow, "Task_" + std::to_string(i), (double) flops, Globals::runtime_cv,
+                                 runtime_rng);
 //        WRENCH_INFO("AAAAA   %s %lf", t->getID().c_str(), t->getFlops() );
     }
 
@@ -492,6 +775,7 @@ Workflow *Simulator::createLevelsWorkflow(std::vector<std::string> spec_tokens)
         throw std::invalid_argument("createLevelsWorkflow(): invalid RNG ssed in workflow specification");
     }
     std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
 
     unsigned long num_levels = (spec_tokens.size() - 1) / 3;
 
@@ -530,8 +814,9 @@ Workflow *Simulator::createLevelsWorkflow(std::vector<std::string> spec_tokens)
     for (unsigned long l = 0; l < num_levels; l++) {
         for (unsigned long t = 0; t < num_tasks[l]; t++) {
             unsigned long flops = (*m_udists[l])(rng);
-            wrench::WorkflowTask *task = workflow->addTask("Task_l" + std::to_string(l) + "_" +
-                                                           std::to_string(t), (double) flops, 1, 1, 1.0);
+            wrench::WorkflowTask *task = addWorkflowTask(workflow, "Task_l" + std::to_string(l) + "_" +
+                                                                   std::to_string(t), (double) flops,
+                                                         Globals::runtime_cv, runtime_rng);
             tasks[l].push_back(task);
         }
     }
@@ -540,7 +825,7 @@ Workflow *Simulator::createLevelsWorkflow(std::vector<std::string> spec_tokens)
     for (unsigned long l = 1; l < num_levels; l++) {
         for (unsigned long t = 0; t < num_tasks[l]; t++) {
             for (unsigned long p = 0; p < num_tasks[l - 1]; p++) {
-                workflow->addControlDependency(tasks[l - 1][p], tasks[l][t]);
+                workflow->addControlDependency(tasks[l - 1][p], tasks[l][t], true);
             }
         }
     }
@@ -551,6 +836,292 @@ Workflow *Simulator::createLevelsWorkflow(std::vector<std::string> spec_tokens)
 
 }
 
+/**
+ * @brief Parse the task duration distribution of a synthetic workflow specification
+ * @param spec: "u-t1-t2" (integral seconds, uniformly sampled), "lognormal-mean-cv", or "pareto-min-alpha"
+ * @return the distribution
+ */
+Simulator::RuntimeDistribution Simulator::parseRuntimeDistribution(std::string spec) {
+    std::istringstream ss(spec);
+    std::string token;
+    std::vector<std::string> tokens;
+    while (std::getline(ss, token, '-')) {
+        tokens.push_back(token);
+    }
+
+    double a, b;
+    if ((tokens.size() != 3) or (sscanf(tokens[1].c_str(), "%lf", &a) != 1) or
+        (sscanf(tokens[2].c_str(), "%lf", &b) != 1) or (a < 0) or (b < 0)) {
+        throw std::invalid_argument("Invalid task duration distribution " + spec);
+    }
+    if (((tokens[0] == "u") and (b < a)) or ((tokens[0] == "pareto") and ((a <= 0) or (b <= 0)))) {
+        throw std::invalid_argument("Invalid task duration distribution " + spec);
+    }
+    if ((tokens[0] != "u") and (tokens[0] != "lognormal") and (tokens[0] != "pareto")) {
+        throw std::invalid_argument("Unknown task duration distribution " + tokens[0]);
+    }
+    return std::make_tuple(tokens[0], a, b);
+}
+
+/**
+ * @brief Sample a task duration
+ * @param distribution: the distribution
+ * @param rng: the random number generator
+ * @return a duration, in seconds
+ */
+double Simulator::sampleRuntime(const RuntimeDistribution &distribution, std::default_random_engine &rng) {
+    if (std::get<0>(distribution) == "u") {
+        std::uniform_int_distribution<unsigned long> udist((unsigned long) std::get<1>(distribution),
+                                                           (unsigned long) std::get<2>(distribution));
+        return (double) udist(rng);
+    } else if (std::get<0>(distribution) == "lognormal") {
+        return WorkflowUtil::sampleFlops(std::get<1>(distribution), std::get<2>(distribution), rng);
+    } else {
+        std::uniform_real_distribution<double> udist(0.0, 1.0);
+        return std::get<1>(distribution) / std::pow(1.0 - udist(rng), 1.0 / std::get<2>(distribution));
+    }
+}
+
+/**
+ * @brief Create a fork-join workflow: k stages of w parallel tasks, each stage between a fork task (the
+ *        join task of the previous stage) and a join task
+ * @param spec_tokens: forkjoin:s:k:w:d
+ * @return the workflow
+ */
+Workflow *Simulator::createForkJoinWorkflow(std::vector<std::string> spec_tokens) {
+    unsigned int seed;
+    unsigned long num_stages;
+    unsigned long width;
+    if ((sscanf(spec_tokens[1].c_str(), "%u", &seed) != 1) or
+        (sscanf(spec_tokens[2].c_str(), "%lu", &num_stages) != 1) or (num_stages < 1) or
+        (sscanf(spec_tokens[3].c_str(), "%lu", &width) != 1) or (width < 1)) {
+        throw std::invalid_argument("createForkJoinWorkflow(): invalid workflow specification");
+    }
+    RuntimeDistribution distribution = parseRuntimeDistribution(spec_tokens[4]);
+    std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
+
+    auto workflow = new Workflow();
+    unsigned long task_id = 0;
+    auto fork = addWorkflowTask(workflow, "Task_" + std::to_string(task_id++), sampleRuntime(distribution, rng),
+                                Globals::runtime_cv, runtime_rng);
+    for (unsigned long stage = 0; stage < num_stages; stage++) {
+        std::vector<WorkflowTask *> stage_tasks;
+        for (unsigned long i = 0; i < width; i++) {
+            auto task = addWorkflowTask(workflow, "Task_" + std::to_string(task_id++),
+                                        sampleRuntime(distribution, rng), Globals::runtime_cv, runtime_rng);
+            workflow->addControlDependency(fork, task, true);
+            stage_tasks.push_back(task);
+        }
+        auto join = addWorkflowTask(workflow, "Task_" + std::to_string(task_id++), sampleRuntime(distribution, rng),
+                                    Globals::runtime_cv, runtime_rng);
+        for (auto task : stage_tasks) {
+            workflow->addControlDependency(task, join, true);
+        }
+        fork = join;
+    }
+    return workflow;
+}
+
+/**
+ * @brief Create a layered random DAG: each task of a layer depends on each task of the previous layer with
+ *        some probability, and on at least one of them
+ * @param spec_tokens: layered:s:l:w:p:d
+ * @return the workflow
+ */
+Workflow *Simulator::createLayeredWorkflow(std::vector<std::string> spec_tokens) {
+    unsigned int seed;
+    unsigned long num_layers;
+    unsigned long width;
+    double edge_density;
+    if ((sscanf(spec_tokens[1].c_str(), "%u", &seed) != 1) or
+        (sscanf(spec_tokens[2].c_str(), "%lu", &num_layers) != 1) or (num_layers < 1) or
+        (sscanf(spec_tokens[3].c_str(), "%lu", &width) != 1) or (width < 1) or
+        (sscanf(spec_tokens[4].c_str(), "%lf", &edge_density) != 1) or (edge_density < 0) or (edge_density > 1)) {
+        throw std::invalid_argument("createLayeredWorkflow(): invalid workflow specification");
+    }
+    RuntimeDistribution distribution = parseRuntimeDistribution(spec_tokens[5]);
+    std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
+
+    auto workflow = new Workflow();
+    std::vector<WorkflowTask *> previous_layer;
+    std::uniform_int_distribution<unsigned long> parent_dist(0, width - 1);
+    for (unsigned long l = 0; l < num_layers; l++) {
+        std::vector<WorkflowTask *> layer;
+        for (unsigned long i = 0; i < width; i++) {
+            auto task = addWorkflowTask(workflow, "Task_l" + std::to_string(l) + "_" + std::to_string(i),
+                                        sampleRuntime(distribution, rng), Globals::runtime_cv, runtime_rng);
+            if (not previous_layer.empty()) {
+                // Skip over the tasks that aren't parents (geometric gaps), so that the cost is in the
+                // number of edges rather than in the square of the width
+                bool has_parent = false;
+                if (edge_density > 0) {
+                    std::geometric_distribution<unsigned long> gap(edge_density);
+                    for (unsigned long p = gap(rng); p < width; p += 1 + gap(rng)) {
+                        workflow->addControlDependency(previous_layer[p], task, true);
+                        has_parent = true;
+                    }
+                }
+                if (not has_parent) {
+                    workflow->addControlDependency(previous_layer[parent_dist(rng)], task, true);
+                }
+            }
+            layer.push_back(task);
+        }
+        previous_layer = layer;
+    }
+    return workflow;
+}
+
+/**
+ * @brief Create a Montage-like workflow: n mProject tasks on a grid of tiles, an mDiffFit task for each pair
+ *        of adjacent tiles, mConcatFit and mBgModel, n mBackground tasks, and mImgtbl, mAdd, mShrink and mJPEG
+ * @param spec_tokens: montage:s:n:d
+ * @return the workflow
+ */
+Workflow *Simulator::createMontageWorkflow(std::vector<std::string> spec_tokens) {
+    unsigned int seed;
+    unsigned long num_tiles;
+    if ((sscanf(spec_tokens[1].c_str(), "%u", &seed) != 1) or
+        (sscanf(spec_tokens[2].c_str(), "%lu", &num_tiles) != 1) or (num_tiles < 1)) {
+        throw std::invalid_argument("createMontageWorkflow(): invalid workflow specification");
+    }
+    RuntimeDistribution distribution = parseRuntimeDistribution(spec_tokens[3]);
+    std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
+
+    auto workflow = new Workflow();
+    auto add_task = [&](std::string id) -> WorkflowTask * {
+        return addWorkflowTask(workflow, id, sampleRuntime(distribution, rng), Globals::runtime_cv, runtime_rng);
+    };
+
+    auto grid_width = (unsigned long) std::ceil(std::sqrt((double) num_tiles));
+    std::vector<WorkflowTask *> projects;
+    for (unsigned long i = 0; i < num_tiles; i++) {
+        projects.push_back(add_task("mProject_" + std::to_string(i)));
+    }
+    auto concat_fit = add_task("mConcatFit");
+    for (unsigned long i = 0; i < num_tiles; i++) {
+        for (unsigned long neighbor : {i + 1, i + grid_width}) {
+            if ((neighbor >= num_tiles) or ((neighbor == i + 1) and (neighbor % grid_width == 0))) {
+                continue;
+            }
+            auto diff_fit = add_task("mDiffFit_" + std::to_string(i) + "_" + std::to_string(neighbor));
+            workflow->addControlDependency(projects[i], diff_fit, true);
+            workflow->addControlDependency(projects[neighbor], diff_fit, true);
+            workflow->addControlDependency(diff_fit, concat_fit, true);
+        }
+    }
+    if (num_tiles == 1) {
+        workflow->addControlDependency(projects[0], concat_fit, true);
+    }
+    auto bg_model = add_task("mBgModel");
+    workflow->addControlDependency(concat_fit, bg_model, true);
+    auto imgtbl = add_task("mImgtbl");
+    for (unsigned long i = 0; i < num_tiles; i++) {
+        auto background = add_task("mBackground_" + std::to_string(i));
+        workflow->addControlDependency(projects[i], background, true);
+        workflow->addControlDependency(bg_model, background, true);
+        workflow->addControlDependency(background, imgtbl, true);
+    }
+    WorkflowTask *previous = imgtbl;
+    for (std::string id : {"mAdd", "mShrink", "mJPEG"}) {
+        auto task = add_task(id);
+        workflow->addControlDependency(previous, task, true);
+        previous = task;
+    }
+    return workflow;
+}
+
+/**
+ * @brief Create an Epigenomics-like workflow: b lanes, each a fastQSplit task, n chains of filterContams,
+ *        sol2sanger, fastq2bfq and map tasks, and a mapMerge task, and then mapMerge, maqIndex and pileup
+ * @param spec_tokens: epigenomics:s:b:n:d
+ * @return the workflow
+ */
+Workflow *Simulator::createEpigenomicsWorkflow(std::vector<std::string> spec_tokens) {
+    unsigned int seed;
+    unsigned long num_lanes;
+    unsigned long num_chunks;
+    if ((sscanf(spec_tokens[1].c_str(), "%u", &seed) != 1) or
+        (sscanf(spec_tokens[2].c_str(), "%lu", &num_lanes) != 1) or (num_lanes < 1) or
+        (sscanf(spec_tokens[3].c_str(), "%lu", &num_chunks) != 1) or (num_chunks < 1)) {
+        throw std::invalid_argument("createEpigenomicsWorkflow(): invalid workflow specification");
+    }
+    RuntimeDistribution distribution = parseRuntimeDistribution(spec_tokens[4]);
+    std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
+
+    auto workflow = new Workflow();
+    auto add_task = [&](std::string id) -> WorkflowTask * {
+        return addWorkflowTask(workflow, id, sampleRuntime(distribution, rng), Globals::runtime_cv, runtime_rng);
+    };
+
+    auto merge = add_task("mapMerge");
+    for (unsigned long lane = 0; lane < num_lanes; lane++) {
+        std::string suffix = "_" + std::to_string(lane);
+        auto split = add_task("fastQSplit" + suffix);
+        auto lane_merge = add_task("mapMerge" + suffix);
+        for (unsigned long chunk = 0; chunk < num_chunks; chunk++) {
+            WorkflowTask *previous = split;
+            for (std::string id : {"filterContams", "sol2sanger", "fastq2bfq", "map"}) {
+                auto task = add_task(id + suffix + "_" + std::to_string(chunk));
+                workflow->addControlDependency(previous, task, true);
+                previous = task;
+            }
+            workflow->addControlDependency(previous, lane_merge, true);
+        }
+        workflow->addControlDependency(lane_merge, merge, true);
+    }
+    auto index = add_task("maqIndex");
+    workflow->addControlDependency(merge, index, true);
+    auto pileup = add_task("pileup");
+    workflow->addControlDependency(index, pileup, true);
+    return workflow;
+}
+
+/**
+ * @brief Create a CyberShake-like workflow: e ExtractSGT tasks, n SeismogramSynthesis tasks for each, a
+ *        PeakValCalcOkaya task for each of these, and ZipSeis and ZipPSA tasks that gather their outputs
+ * @param spec_tokens: cybershake:s:e:n:d
+ * @return the workflow
+ */
+Workflow *Simulator::createCyberShakeWorkflow(std::vector<std::string> spec_tokens) {
+    unsigned int seed;
+    unsigned long num_extractions;
+    unsigned long num_synthesis;
+    if ((sscanf(spec_tokens[1].c_str(), "%u", &seed) != 1) or
+        (sscanf(spec_tokens[2].c_str(), "%lu", &num_extractions) != 1) or (num_extractions < 1) or
+        (sscanf(spec_tokens[3].c_str(), "%lu", &num_synthesis) != 1) or (num_synthesis < 1)) {
+        throw std::invalid_argument("createCyberShakeWorkflow(): invalid workflow specification");
+    }
+    RuntimeDistribution distribution = parseRuntimeDistribution(spec_tokens[4]);
+    std::default_random_engine rng(seed);
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
+
+    auto workflow = new Workflow();
+    auto add_task = [&](std::string id) -> WorkflowTask * {
+        return addWorkflowTask(workflow, id, sampleRuntime(distribution, rng), Globals::runtime_cv, runtime_rng);
+    };
+
+    auto zip_seis = add_task("ZipSeis");
+    auto zip_psa = add_task("ZipPSA");
+    for (unsigned long e = 0; e < num_extractions; e++) {
+        auto extract = add_task("ExtractSGT_" + std::to_string(e));
+        for (unsigned long i = 0; i < num_synthesis; i++) {
+            std::string suffix = "_" + std::to_string(e) + "_" + std::to_string(i);
+            auto synthesis = add_task("SeismogramSynthesis" + suffix);
+            workflow->addControlDependency(extract, synthesis, true);
+            workflow->addControlDependency(synthesis, zip_seis, true);
+            auto peak = add_task("PeakValCalcOkaya" + suffix);
+            workflow->addControlDependency(synthesis, peak, true);
+            workflow->addControlDependency(peak, zip_psa, true);
+        }
+    }
+    return workflow;
+}
+
 Workflow *Simulator::createWorkflowFromFile(std::string type, std::vector<std::string> spec_tokens) {
     std::string filename = spec_tokens[1];
 
@@ -567,12 +1138,44 @@ Workflow *Simulator::createWorkflowFromFile(std::string type, std::vector<std::s
         throw std::runtime_error("Cannot import workflow from file: " + std::string(e.what()));
     }
 
+    // Per-job runtime variations, if any
+    std::map<std::string, double> runtime_cvs;
+    if (type == "json") {
+        std::ifstream file(filename);
+        nlohmann::json json;
+        try {
+            file >> json;
+        } catch (std::exception &e) {
+            throw std::runtime_error("Cannot import workflow from file: " + std::string(e.what()));
+        }
+        if (json.count("workflow") and json["workflow"].count("jobs")) {
+            for (auto &job : json["workflow"]["jobs"]) {
+                if (job.count("name") and job.count("runtimeCV")) {
+                    runtime_cvs[job["name"].get<std::string>()] = job["runtimeCV"].get<double>();
+                }
+            }
+        }
+    }
+
     auto workflow = new Workflow();
+    std::default_random_engine runtime_rng(Globals::runtime_seed);
 
     // Add task replicas
     for (auto t : original_workflow->getTasks()) {
 //    WRENCH_INFO("t->getFlops() = %lf", t->getFlops());
-        workflow->addTask(t->getID(), t->getFlops(), 1, 1, 1.0);
+        double cv = Globals::runtime_cv;
+        if (runtime_cvs.find(t->getID()) != runtime_cvs.end()) {
+            cv = runtime_cvs[t->getID()];
+        }
+        auto task = addWorkflowTask(workflow, t->getID(), t->getFlops(), cv, runtime_rng);
+
+        // Keep the files, for the staging cost model
+        for (auto f : t->getInputFiles()) {
+            WorkflowUtil::addTaskFile(task, f->getID(), f->getSize(), true);
+        }
+        for (auto f : t->getOutputFiles()) {
+            WorkflowUtil::addTaskFile(task, f->getID(), f->getSize(), false);
+        }
     }
 
     // Deal with all dependencies (brute-force, but whatever)
@@ -610,6 +1213,12 @@ WMS *Simulator::createWMS(std::string hostname,
         tokens.push_back(token);
     }
 
+    // Only the static algorithms simulate staging, so the others must not count it in their makespan estimates
+    if ((tokens[0] != "static") and (Globals::staging_bandwidth > 0)) {
+        std::cerr << "Ignoring --staging-bandwidth, as the " << tokens[0] << " algorithm doesn't simulate staging\n";
+        Globals::staging_bandwidth = 0;
+    }
+
     if (tokens[0] == "static") {
 
         if (tokens.size() != 2) {
@@ -621,11 +1230,12 @@ WMS *Simulator::createWMS(std::string hostname,
 
     } else if (tokens[0] == "zhang") {
 
-        if (tokens.size() != 4) {
+        if ((tokens.size() != 4) and (tokens.size() != 5)) {
             throw std::invalid_argument("createWMS(): Invalid zhang specification");
         }
 
         bool global, bsearch, prediction;
+        bool adaptive = false;
 
         if (tokens[1] == "global") {
             global = true;
@@ -651,21 +1261,40 @@ WMS *Simulator::createWMS(std::string hostname,
             throw std::invalid_argument("createWMS(): Invalid zhang specification");
         }
 
-        return new ZhangWMS(this, hostname, batch_service, max_num_jobs, global, bsearch, prediction);
+        if (tokens.size() == 5) {
+            if (tokens[4] == "adaptive") {
+                adaptive = true;
+            } else {
+                throw std::invalid_argument("createWMS(): Invalid zhang specification");
+            }
+        }
+
+        return new ZhangWMS(this, hostname, batch_service, max_num_jobs, global, bsearch, prediction, adaptive);
 
     } else if (tokens[0] == "glume") {
 
-        if (tokens.size() != 3) {
+        if ((tokens.size() != 3) and (tokens.size() != 4)) {
             throw std::invalid_argument("createWMS(): Invalid glume specification");
         }
 
         double waste_bound = std::stod(tokens[1]);
         double beat_bound = std::stod(tokens[2]);
 
-        return new GlumeWMS(this, hostname, waste_bound, beat_bound, batch_service);
+        bool multiway = false;
+        if (tokens.size() == 4) {
+            if (tokens[3] == "multiway") {
+                multiway = true;
+            } else if (tokens[3] == "twoway") {
+                multiway = false;
+            } else {
+                throw std::invalid_argument("createWMS(): Invalid glume specification");
+            }
+        }
+
+        return new GlumeWMS(this, hostname, waste_bound, beat_bound, multiway, batch_service);
 
     } else if (tokens[0] == "levelbylevel") {
-        if (tokens.size() != 3) {
+        if ((tokens.size() != 3) and (tokens.size() != 4)) {
             throw std::invalid_argument("createWMS(): Invalid levelbylevel specification");
         }
         bool overlap;
@@ -676,7 +1305,20 @@ WMS *Simulator::createWMS(std::string hostname,
         } else {
             throw std::invalid_argument("createWMS(): Invalid levelbylevel specification");
         }
-        return new LevelByLevelWMS(this, hostname, overlap, tokens[2], batch_service);
+        unsigned long lookahead_depth = 2;
+        bool timed_submissions = false;
+        if (tokens.size() == 4) {
+            if (sscanf(tokens[3].c_str(), "timed-%lu", &lookahead_depth) == 1) {
+                timed_submissions = true;
+            } else if (sscanf(tokens[3].c_str(), "depth-%lu", &lookahead_depth) != 1) {
+                throw std::invalid_argument("createWMS(): Invalid levelbylevel specification");
+            }
+            if ((not overlap) or (lookahead_depth < 1)) {
+                throw std::invalid_argument("createWMS(): Invalid levelbylevel specification");
+            }
+        }
+        return new LevelByLevelWMS(this, hostname, overlap, tokens[2], batch_service, lookahead_depth,
+                                   timed_submissions);
 
     } else {
         throw std::invalid_argument("createStandardJobScheduler(): Unknown algorithm type " + tokens[0]);
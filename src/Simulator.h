@@ -4,10 +4,16 @@
 #define TASK_CLUSTERING_BATCH_SIMULATOR_SIMULATOR_H
 
 #include "wrench-dev.h"
+#include <random>
+#include <tuple>
 
 
 #define EXECUTION_TIME_FUDGE_FACTOR 1.5
 
+// How long a WMS keeps waiting for more events after one arrived before acting on them all: events of the
+// same date reach the WMS through messages that take a (tiny) simulated time, so a zero timeout would miss them
+#define EVENT_COALESCING_TIMEOUT 0.000001
+
 namespace wrench {
 
     class Simulator {
@@ -23,16 +29,38 @@ namespace wrench {
 
         int main(int argc, char **argv);
 
+        void parseOptions(int *argc, char **argv);
+
         void setupSimulationPlatform(wrench::Simulation *simulation, unsigned long num_compute_nodes);
 
         wrench::Workflow *createWorkflow(std::string workflow_spec);
 
+        wrench::WorkflowTask *addWorkflowTask(wrench::Workflow *workflow, std::string id, double nominal_flops, double cv,
+                                              std::default_random_engine &runtime_rng);
+
         wrench::Workflow *createIndepWorkflow(std::vector<std::string> spec_tokens);
 
         wrench::Workflow *createLevelsWorkflow(std::vector<std::string> spec_tokens);
 
+        wrench::Workflow *createForkJoinWorkflow(std::vector<std::string> spec_tokens);
+
+        wrench::Workflow *createLayeredWorkflow(std::vector<std::string> spec_tokens);
+
+        wrench::Workflow *createMontageWorkflow(std::vector<std::string> spec_tokens);
+
+        wrench::Workflow *createEpigenomicsWorkflow(std::vector<std::string> spec_tokens);
+
+        wrench::Workflow *createCyberShakeWorkflow(std::vector<std::string> spec_tokens);
+
         wrench::Workflow *createWorkflowFromFile(std::string type, std::vector<std::string> spec_tokens);
 
+        // Task duration distribution of the synthetic workflows: (type, first parameter, second parameter)
+        typedef std::tuple<std::string, double, double> RuntimeDistribution;
+
+        static RuntimeDistribution parseRuntimeDistribution(std::string spec);
+
+        static double sampleRuntime(const RuntimeDistribution &distribution, std::default_random_engine &rng);
+
         wrench::WMS *
         createWMS(std::string scheduler_spec, std::shared_ptr<wrench::BatchComputeService> batch_service, unsigned long max_num_jobs,
                   std::string algorithm_name);
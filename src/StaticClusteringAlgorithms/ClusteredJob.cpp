@@ -7,8 +7,11 @@
  * (at your option) any later version.
  */
 
+#include <cfloat>
 #include <Util/WorkflowUtil.h>
+#include <Util/ParetoFront.h>
 #include "ClusteredJob.h"
+#include "Globals.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(clustered_job, "Log category for Clustered Job");
 
@@ -87,16 +90,40 @@ namespace wrench {
         // Build job configurations
         unsigned long real_max_num_nodes = std::min(this->getNumTasks(), max_num_nodes);
 
+        // Compute the makespans for all numbers of nodes in parallel, except for those that are too wasteful
+        // even with a lower bound on their makespan (the waste increases with the makespan)
+        std::vector<double> makespans(real_max_num_nodes, DBL_MAX);
+        double all_tasks_time = 0.0;
+        if (real_max_num_nodes > 0) {
+            makespans[0] = WorkflowUtil::estimateMakespan(this->tasks, 1, core_speed);
+            all_tasks_time = makespans[0];
+        }
+        std::tuple<double, double, double> makespan_bounds = WorkflowUtil::getMakespanBounds(this->tasks, core_speed);
+        std::vector<unsigned long> num_nodes_to_estimate;
+        std::vector<std::tuple<std::vector<WorkflowTask *> *, unsigned long>> configurations;
+        for (unsigned long n = 2; n <= real_max_num_nodes; n++) {
+            double bound = WorkflowUtil::getMakespanLowerBound(makespan_bounds, n);
+            if ((n * bound - all_tasks_time) / (n * bound) > this->waste_bound) {
+                Globals::num_pruned_makespan_estimates++;
+                continue;
+            }
+            num_nodes_to_estimate.push_back(n);
+            configurations.push_back(std::make_tuple(&(this->tasks), n));
+        }
+        std::vector<double> estimated_makespans = WorkflowUtil::estimateMakespans(configurations, core_speed);
+        for (unsigned long c = 0; c < num_nodes_to_estimate.size(); c++) {
+            makespans[num_nodes_to_estimate[c] - 1] = estimated_makespans[c];
+        }
+
         std::string job_id_prefix = "my_tentative_job";
         std::set<std::tuple<std::string, unsigned long, unsigned long, double>> set_of_job_configurations;
         unsigned long num_jobs = real_max_num_nodes;
         for (unsigned int n = 1; n <= real_max_num_nodes; n++) {
-            double walltime_seconds = this->estimateMakespan(core_speed, n);
+            double walltime_seconds = makespans[n - 1];
 
-            // Calculate the wasted ratio
-            double all_tasks_time = this->estimateMakespan(core_speed, 1);
+            // Calculate the wasted ratio (known to be too high if the makespan wasn't estimated)
             double curr_waste = (n * walltime_seconds - all_tasks_time) / (n * walltime_seconds);
-            if (curr_waste > this->waste_bound) {
+            if ((walltime_seconds == DBL_MAX) or (curr_waste > this->waste_bound)) {
                 num_jobs--;
                 continue;
             }
@@ -131,6 +158,7 @@ namespace wrench {
 
 
         // Find out the best
+        ParetoFront pareto_front;
         unsigned long best_num_nodes = ULONG_MAX;
         double best_finish_time = -1.0;
         for (auto estimate : jobs_estimated_start_times) {
@@ -153,6 +181,7 @@ namespace wrench {
 //        std::cerr << "===> " << num_nodes << " : " << start_time  << "\n";
 
             double finish_time = start_time + makespan;
+            pareto_front.add(num_nodes, finish_time, num_nodes * makespan);
 
             WRENCH_INFO("  - QWTE with %lu node: start time=%lf + makespan=%lf  =  finishtime=%lf", num_nodes,
                         start_time, makespan, finish_time);
@@ -163,6 +192,13 @@ namespace wrench {
             }
         }
 
+        if (ParetoFront::isUsedForChoice()) {
+            best_num_nodes = pareto_front.pick(Globals::pareto_weight);
+        }
+        if (Globals::export_pareto_fronts) {
+            Globals::sim_json["pareto_fronts"].push_back(pareto_front.toJSON());
+        }
+
         WRENCH_INFO("Opted to use %lu compute nodes!", best_num_nodes);
 
         //std::cout << "NODES: " << best_num_nodes << std::endl;
@@ -203,9 +239,78 @@ namespace wrench {
         return max_parallelism;
     }
 
+    /**
+     * @brief Split the job into jobs with different numbers of nodes and durations, to be submitted together, so
+     *        that the nodes that run out of work early are released early (see
+     *        WorkflowUtil::getStaggeredAllocations()). The split is compared to the single job in the output.
+     * @param core_speed: the core speed
+     * @param max_num_jobs: the maximum number of jobs
+     * @return the jobs (just this one if the job can't be split, or if splitting doesn't reserve fewer node-seconds)
+     */
+    std::vector<ClusteredJob *> ClusteredJob::getStaggeredJobs(double core_speed, unsigned long max_num_jobs) {
+        if (this->num_nodes == 0) {
+            throw std::runtime_error("getStaggeredJobs(): Cannot split a job with 0 nodes!");
+        }
+
+        auto allocations = WorkflowUtil::getStaggeredAllocations(this->tasks, this->num_nodes, core_speed,
+                                                                 max_num_jobs);
+        if (allocations.size() < 2) {
+            return {this};
+        }
+
+        double makespan = this->estimateMakespan(core_speed);
+        double requested_time = makespan * WorkflowUtil::getWalltimeFactor(this->tasks, this->num_nodes, core_speed);
+
+        nlohmann::json comparison;
+        comparison["num_tasks"] = this->tasks.size();
+        comparison["single"]["nodes"] = this->num_nodes;
+        comparison["single"]["estimated_makespan"] = makespan;
+        comparison["single"]["requested_time"] = requested_time;
+        comparison["staggered"] = nlohmann::json::array();
+
+        std::vector<ClusteredJob *> jobs;
+        double staggered_makespan = 0.0;
+        double staggered_node_seconds = 0.0;
+        for (auto const &allocation : allocations) {
+            auto job = new ClusteredJob();
+            for (auto task : std::get<0>(allocation)) {
+                job->addTask(task);
+            }
+            job->setNumNodes(std::get<1>(allocation), this->num_nodes_based_on_queue_wait_time_predictions);
+            job->setWasteBound(this->waste_bound);
+            jobs.push_back(job);
+
+            double job_makespan = job->estimateMakespan(core_speed);
+            double job_requested_time = job_makespan * WorkflowUtil::getWalltimeFactor(job->tasks, job->num_nodes,
+                                                                                       core_speed);
+            staggered_makespan = std::max<double>(staggered_makespan, job_makespan);
+            staggered_node_seconds += job->num_nodes * job_requested_time;
+
+            nlohmann::json job_json;
+            job_json["nodes"] = job->num_nodes;
+            job_json["num_tasks"] = job->tasks.size();
+            job_json["estimated_makespan"] = job_makespan;
+            job_json["requested_time"] = job_requested_time;
+            comparison["staggered"].push_back(job_json);
+        }
+
+        comparison["estimated_makespan_delta"] = staggered_makespan - makespan;
+        comparison["requested_node_seconds_delta"] = staggered_node_seconds - this->num_nodes * requested_time;
+        Globals::sim_json["staggered_jobs"].push_back(comparison);
+
+        WRENCH_INFO("Split a %lu-node job into %lu staggered jobs (%.2lf fewer requested node-seconds)",
+                    this->num_nodes, jobs.size(), this->num_nodes * requested_time - staggered_node_seconds);
+
+        return jobs;
+    }
+
     void ClusteredJob::setWasteBound(double waste_bound) {
         // TODO error checking?
         this->waste_bound = waste_bound;
     }
 
+    double ClusteredJob::getWasteBound() {
+        return this->waste_bound;
+    }
+
 };
@@ -45,6 +45,10 @@ namespace wrench {
 
         void setWasteBound(double waste_bound);
 
+        double getWasteBound();
+
+        std::vector<ClusteredJob *> getStaggeredJobs(double core_speed, unsigned long max_num_jobs);
+
     private:
         std::vector<wrench::WorkflowTask *> tasks;
         unsigned long num_nodes = 0;
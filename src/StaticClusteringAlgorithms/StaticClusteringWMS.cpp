@@ -1,10 +1,16 @@
 
 
 #include <stdio.h>
+#include <ctime>
+#include <cmath>
+#include <queue>
+#include <fstream>
+#include <iomanip>
 
 #include <Util/WorkflowUtil.h>
 #include "StaticClusteringWMS.h"
 #include "ClusteredJob.h"
+#include "Globals.h"
 
 using namespace wrench;
 
@@ -25,6 +31,46 @@ void StaticClusteringWMS::processEventStandardJobCompletion(std::shared_ptr<Stan
     auto job = e->standard_job;
     WRENCH_INFO("Job %s has completed", job->getName().c_str());
 
+    // Run the tasks of running lookahead jobs that this completion made ready, and queue the jobs it made ready
+    for (auto const &t : job->getTasks()) {
+        for (auto child : t->getWorkflow()->getTaskChildren(t)) {
+            if (child->getState() != WorkflowTask::READY) {
+                continue;
+            }
+            auto pending_job = this->pending_job_of_task.find(child);
+            if (pending_job != this->pending_job_of_task.end()) {
+                enqueueIfReady(pending_job->second);
+            }
+            for (auto ph : this->lookahead_placeholder_jobs) {
+                if ((ph->start_date >= 0) and ph->hasTask(child)) {
+                    ph->enqueueReadyTask(child);
+                }
+            }
+        }
+    }
+    for (auto ph : this->lookahead_placeholder_jobs) {
+        if (ph->start_date >= 0) {
+            dispatchLookaheadTasks(ph);
+        }
+    }
+
+    // A task of a lookahead job, which ran in its pilot job
+    auto lookahead_job = this->lookahead_standard_jobs.find(job.get());
+    if (lookahead_job != this->lookahead_standard_jobs.end()) {
+        PlaceHolderJob *placeholder_job = lookahead_job->second;
+        this->lookahead_standard_jobs.erase(lookahead_job);
+        for (auto const &t : job->getTasks()) {
+            this->simulator->used_node_seconds += t->getFlops() / this->core_speed;
+            if (placeholder_job != nullptr) {
+                placeholder_job->markTaskCompleted(t);
+            }
+        }
+        if ((placeholder_job != nullptr) and placeholder_job->areAllTasksCompleted()) {
+            terminateLookaheadJob(placeholder_job);
+        }
+        return;
+    }
+
 
     double first_task_start_time = DBL_MAX;
     for (auto const &t : job->getTasks()) {
@@ -36,24 +82,135 @@ void StaticClusteringWMS::processEventStandardJobCompletion(std::shared_ptr<Stan
     double job_duration = this->simulation->getCurrentSimulatedDate() - first_task_start_time;
     double wasted_node_seconds = num_requested_nodes * job_duration;
     for (auto const &t : job->getTasks()) {
+        // Staging tasks leave the nodes idle
+        if (this->staging_tasks.find(t) != this->staging_tasks.end()) {
+            continue;
+        }
         this->simulator->used_node_seconds += t->getFlops() / this->core_speed;
         wasted_node_seconds -= t->getFlops() / this->core_speed;
     }
 
-    this->simulator->wasted_node_seconds = wasted_node_seconds;
+    this->simulator->wasted_node_seconds += wasted_node_seconds;
 
     this->simulator->total_queue_wait_time += (first_task_start_time - job->getSubmitDate());
 
-    this->num_jobs_in_systems--;
+    // Re-plan if the queue wait turned out to be far from its prediction, with larger clusters (i.e., fewer
+    // queue waits) if it was longer, and smaller ones if it was shorter. This is decided when the job completes,
+    // not when it starts: the batch service doesn't announce job starts, and the queue wait is only known from
+    // the start date of the job's first task.
+    auto predicted_wait_time = this->predicted_wait_times.find(job.get());
+    if (predicted_wait_time != this->predicted_wait_times.end()) {
+        double observed = first_task_start_time - job->getSubmitDate();
+        double predicted = predicted_wait_time->second;
+        this->predicted_wait_times.erase(predicted_wait_time);
+        if (std::abs(observed - predicted) > Globals::replan_margin * std::max<double>(predicted, 60.0)) {
+            WRENCH_INFO("Observed a queue wait of %.2lf seconds, but %.2lf were predicted: will re-plan",
+                        observed, predicted);
+            double drift = std::min<double>(4.0, std::max<double>(0.25, (observed + 60.0) / (predicted + 60.0)));
+            this->cluster_size_factor = std::min<double>(64.0, std::max<double>(1.0 / 64.0,
+                                                                                this->cluster_size_factor * drift));
+            this->replan_needed = true;
+        }
+    }
+
+    if (this->job_arrays.completeElement(job.get())) {
+        this->num_jobs_in_systems--;
+    }
 }
 
 
 void StaticClusteringWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> e) {
+    // Tasks of a lookahead job fail when its pilot job expires, and are then submitted again
+    auto lookahead_job = this->lookahead_standard_jobs.find(e->standard_job.get());
+    if (lookahead_job != this->lookahead_standard_jobs.end()) {
+        WRENCH_INFO("Job %s has failed, as its pilot job expired", e->standard_job->getName().c_str());
+        this->lookahead_standard_jobs.erase(lookahead_job);
+        return;
+    }
     throw std::runtime_error("A job has failed, which shouldn't happen");
 }
 
 
-std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
+void StaticClusteringWMS::processEventPilotJobStart(std::shared_ptr<PilotJobStartedEvent> e) {
+    PlaceHolderJob *placeholder_job = nullptr;
+    for (auto ph : this->lookahead_placeholder_jobs) {
+        if (ph->pilot_job == e->pilot_job) {
+            placeholder_job = ph;
+            break;
+        }
+    }
+    if (placeholder_job == nullptr) {
+        throw std::runtime_error("Got a pilot job start, but no matching lookahead job found");
+    }
+    WRENCH_INFO("Lookahead job %s has started", e->pilot_job->getName().c_str());
+
+    this->simulator->total_queue_wait_time +=
+            this->simulation->getCurrentSimulatedDate() - e->pilot_job->getSubmitDate();
+
+    placeholder_job->start_date = this->simulation->getCurrentSimulatedDate();
+    placeholder_job->initializeReadyTasks();
+    dispatchLookaheadTasks(placeholder_job);
+}
+
+
+void StaticClusteringWMS::processEventPilotJobExpiration(std::shared_ptr<PilotJobExpiredEvent> e) {
+    PlaceHolderJob *placeholder_job = nullptr;
+    for (auto ph : this->lookahead_placeholder_jobs) {
+        if (ph->pilot_job == e->pilot_job) {
+            placeholder_job = ph;
+            break;
+        }
+    }
+    if (placeholder_job == nullptr) {
+        throw std::runtime_error("Got a pilot job expiration, but no matching lookahead job found");
+    }
+    WRENCH_INFO("Lookahead job %s has expired", e->pilot_job->getName().c_str());
+
+    ulong num_used_nodes;
+    sscanf(e->pilot_job->getServiceSpecificArguments()["-N"].c_str(), "%lu", &num_used_nodes);
+    ulong num_used_minutes;
+    sscanf(e->pilot_job->getServiceSpecificArguments()["-t"].c_str(), "%lu", &num_used_minutes);
+    double wasted_node_seconds = 60.0 * num_used_minutes * num_used_nodes;
+
+    // The tasks that didn't complete go back to the jobs to submit, in a job of their own
+    ClusteredJob *remaining_job = nullptr;
+    for (auto t : placeholder_job->tasks) {
+        if (t->getState() == WorkflowTask::COMPLETED) {
+            wasted_node_seconds -= t->getFlops() / this->core_speed;
+        } else {
+            if (remaining_job == nullptr) {
+                remaining_job = new ClusteredJob();
+                remaining_job->setNumNodes(placeholder_job->clustered_job->getNumNodes());
+            }
+            remaining_job->addTask(t);
+        }
+    }
+    this->simulator->wasted_node_seconds += wasted_node_seconds;
+
+    if (remaining_job != nullptr) {
+        this->simulator->num_pilot_job_expirations_with_remaining_tasks_to_do++;
+        this->expired_jobs.insert(remaining_job);
+    }
+
+    for (auto &lookahead_job : this->lookahead_standard_jobs) {
+        if (lookahead_job.second == placeholder_job) {
+            lookahead_job.second = nullptr;
+        }
+    }
+    this->lookahead_placeholder_jobs.erase(placeholder_job);
+    delete placeholder_job;
+    this->num_jobs_in_systems--;
+}
+
+
+/**
+ * @brief Compute the clustering according to the algorithm spec
+ * @param start_level: the first level to cluster (only the hc, dfjs, dfjs_bfd, locality, hrb, hifb and hdb
+ *        methods support
+ *        a non-zero one, used when re-planning)
+ * @return the clustered jobs
+ */
+std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs(unsigned long start_level) {
 
     std::istringstream ss(this->algorithm_spec);
     std::string token;
@@ -65,6 +222,24 @@ std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
         tokens.push_back(token);
     }
 
+    /** A plan exported by a previous run (the file path may contain '-') **/
+    if (tokens[0] == "plan") {
+        if (tokens.size() < 2) {
+            throw std::invalid_argument("Invalid static:plan specification");
+        }
+        return createPlanJobs(this->algorithm_spec.substr(std::string("plan-").length()));
+    }
+
+    if (start_level == 0) {
+        this->vertically_clustered = (tokens[0] == "vc") or ((tokens.size() > 1) and (tokens[1] == "vprior"));
+    }
+
+    // Re-planning doesn't redo the prior vertical clustering, which already changed the workflow
+    if ((start_level > 0) and (tokens.size() > 1) and (tokens[1] == "vprior")) {
+        tokens[1] = "vnone";
+    }
+    unsigned long end_level = this->getWorkflow()->getNumLevels() - 1;
+
     /** A level by level split **/
     if (tokens[0] == "levelbylevel") {
         if (tokens.size() != 2) {
@@ -144,8 +319,9 @@ std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
         if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
             throw std::runtime_error("Invalid static:hc specification");
         }
+        num_tasks_per_cluster = scaleClusterSize(num_tasks_per_cluster);
         return createHCJobs(tokens[1], num_tasks_per_cluster, num_nodes_per_cluster,
-                            this->getWorkflow(), 0, this->getWorkflow()->getNumLevels() - 1);
+                            this->getWorkflow(), start_level, end_level);
     }
 
     /** DFJS Clustering **/
@@ -162,8 +338,47 @@ std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
         if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
             throw std::runtime_error("Invalid static:dfjs specification");
         }
+        num_seconds_per_cluster = scaleClusterDuration(num_seconds_per_cluster, start_level, end_level);
         return createDFJSJobs(tokens[1], num_seconds_per_cluster, num_nodes_per_cluster,
-                              this->core_speed, this->getWorkflow(), 0, this->getWorkflow()->getNumLevels() - 1);
+                              this->core_speed, this->getWorkflow(), start_level, end_level);
+    }
+
+    /** DFJS Clustering, best-fit decreasing **/
+    if (tokens[0] == "dfjs_bfd") {
+        if (tokens.size() != 4) {
+            throw std::invalid_argument("Invalid static:dfjs_bfd specification");
+        }
+        unsigned long num_seconds_per_cluster;
+        unsigned long num_nodes_per_cluster;
+        if ((sscanf(tokens[2].c_str(), "%lu", &num_seconds_per_cluster) != 1) or (num_seconds_per_cluster < 1) or
+            (sscanf(tokens[3].c_str(), "%lu", &num_nodes_per_cluster) != 1)) {
+            throw std::invalid_argument("Invalid static:dfjs_bfd specification");
+        }
+        if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
+            throw std::runtime_error("Invalid static:dfjs_bfd specification");
+        }
+        num_seconds_per_cluster = scaleClusterDuration(num_seconds_per_cluster, start_level, end_level);
+        return createDFJSBFDJobs(tokens[1], num_seconds_per_cluster, num_nodes_per_cluster,
+                                 this->core_speed, this->getWorkflow(), start_level, end_level);
+    }
+
+    /** Locality-aware Clustering **/
+    if (tokens[0] == "locality") {
+        if (tokens.size() != 4) {
+            throw std::invalid_argument("Invalid static:locality specification");
+        }
+        unsigned long num_seconds_per_cluster;
+        unsigned long num_nodes_per_cluster;
+        if ((sscanf(tokens[2].c_str(), "%lu", &num_seconds_per_cluster) != 1) or (num_seconds_per_cluster < 1) or
+            (sscanf(tokens[3].c_str(), "%lu", &num_nodes_per_cluster) != 1)) {
+            throw std::invalid_argument("Invalid static:locality specification");
+        }
+        if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
+            throw std::runtime_error("Invalid static:locality specification");
+        }
+        num_seconds_per_cluster = scaleClusterDuration(num_seconds_per_cluster, start_level, end_level);
+        return createLocalityJobs(tokens[1], num_seconds_per_cluster, num_nodes_per_cluster,
+                                  this->core_speed, this->getWorkflow(), start_level, end_level);
     }
 
     /** HRB Clustering **/
@@ -180,8 +395,9 @@ std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
         if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
             throw std::runtime_error("Invalid static:hrb specification");
         }
+        num_tasks_per_cluster = scaleClusterSize(num_tasks_per_cluster);
         return createHRBJobs(tokens[1], num_tasks_per_cluster, num_nodes_per_cluster,
-                             this->core_speed, this->getWorkflow(), 0, this->getWorkflow()->getNumLevels() - 1);
+                             this->core_speed, this->getWorkflow(), start_level, end_level);
     }
 
     /** HIFB Clustering **/
@@ -198,8 +414,9 @@ std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
         if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
             throw std::runtime_error("Invalid static:hifb specification");
         }
+        num_tasks_per_cluster = scaleClusterSize(num_tasks_per_cluster);
         return createHIFBJobs(tokens[1], num_tasks_per_cluster, num_nodes_per_cluster,
-                              this->getWorkflow(), 0, this->getWorkflow()->getNumLevels() - 1);
+                              this->getWorkflow(), start_level, end_level);
     }
 
     /** HDB Clustering **/
@@ -216,8 +433,24 @@ std::set<ClusteredJob *> StaticClusteringWMS::createClusteredJobs() {
         if ((tokens[1] != "vprior") and (tokens[1] != "vposterior") and (tokens[1] != "vnone")) {
             throw std::runtime_error("Invalid static:hdb specification");
         }
+        num_tasks_per_cluster = scaleClusterSize(num_tasks_per_cluster);
         return createHDBJobs(tokens[1], num_tasks_per_cluster, num_nodes_per_cluster,
-                             this->getWorkflow(), 0, this->getWorkflow()->getNumLevels() - 1);
+                             this->getWorkflow(), start_level, end_level);
+    }
+
+    /** PCP Clustering **/
+    if (tokens[0] == "pcp") {
+        if (tokens.size() != 3) {
+            throw std::invalid_argument("Invalid static:pcp specification");
+        }
+        unsigned long num_seconds_per_cluster;
+        unsigned long num_nodes_per_cluster;
+        if ((sscanf(tokens[1].c_str(), "%lu", &num_seconds_per_cluster) != 1) or (num_seconds_per_cluster < 1) or
+            (sscanf(tokens[2].c_str(), "%lu", &num_nodes_per_cluster) != 1)) {
+            throw std::invalid_argument("Invalid static:pcp specification");
+        }
+        return createPCPJobs(num_seconds_per_cluster, num_nodes_per_cluster, this->number_of_nodes,
+                             this->core_speed, this->getWorkflow());
     }
 
     /** VC Clustering **/
@@ -256,35 +489,65 @@ int StaticClusteringWMS::main() {
 
     // Compute the clustering according to the method
     std::set<ClusteredJob *> jobs = this->createClusteredJobs();
+    if (not Globals::plan_file.empty()) {
+        this->exportPlan(jobs);
+    }
+
+    this->cluster_size_factor = 1.0;
+    this->replan_needed = false;
+    this->num_replans = 0;
+    this->replan_cpu_time = 0;
 
 //  WRENCH_INFO("NUMBER OF CLUSTERS JOBS = %ld", jobs.size());
 //  WRENCH_INFO("MAX NUM JOBS = %ld", this->max_num_jobs);
 
     this->num_jobs_in_systems = 0;
+    this->num_lookahead_jobs = 0;
+    this->staged_bytes = 0;
+    this->staging_time = 0;
+
+    // Compute the bottom level of each task, by which jobs are prioritized when the job limit binds
+    for (long level = (long) this->getWorkflow()->getNumLevels() - 1; level >= 0; level--) {
+        for (auto t : this->getWorkflow()->getTasksInTopLevelRange(level, level)) {
+            double longest_child_path = 0;
+            for (auto child : this->getWorkflow()->getTaskChildren(t)) {
+                longest_child_path = std::max<double>(longest_child_path, this->bottom_levels[child]);
+            }
+            this->bottom_levels[t] = WorkflowUtil::getNominalFlops(t) / this->core_speed + longest_child_path;
+        }
+    }
+
+    indexPendingJobs(jobs);
 
     while (true) {
 
-        while (this->num_jobs_in_systems < this->max_num_jobs) {
-            // Try to find a ready job
-            ClusteredJob *to_submit = nullptr;
-            for (auto j : jobs) {
-//        WRENCH_INFO("IS THIS JOB READY?");
-//        for (auto t : j->getTasks()) {
-//          WRENCH_INFO("    - %s", t->getID().c_str());
-//        }
-                if (j->isReady()) {
-                    to_submit = j;
-                    break;
-                }
-            }
-            if (to_submit == nullptr) {
-                break;
+        if (not this->expired_jobs.empty()) {
+            jobs.insert(this->expired_jobs.begin(), this->expired_jobs.end());
+            this->expired_jobs.clear();
+            indexPendingJobs(jobs);
+        }
+
+        // Submit the ready jobs, those with the longest remaining path first
+        while ((not this->ready_jobs.empty()) and (this->num_jobs_in_systems < this->max_num_jobs)) {
+            ClusteredJob *to_submit = std::get<2>(*this->ready_jobs.begin());
+            this->ready_jobs.erase(this->ready_jobs.begin());
+            // Already submitted as part of a job array (or as a lookahead job)
+            if (jobs.find(to_submit) == jobs.end()) {
+                continue;
             }
 
-            // Submit the job
-            submitClusteredJob(to_submit);
+            // Submit the job, or the job array of the ready single-task jobs shaped like it
+            if (JobArrays::isEnabled() and isJobArrayElement(to_submit)) {
+                submitJobArray(to_submit, jobs);
+                this->num_jobs_in_systems++;
+                continue;
+            }
+            this->num_jobs_in_systems += submitClusteredJob(to_submit, this->max_num_jobs - this->num_jobs_in_systems);
             jobs.erase(to_submit);
-            this->num_jobs_in_systems++;
+        }
+
+        if (Globals::static_lookahead) {
+            submitLookaheadJobs(jobs);
         }
 
         // Wait for a workflow execution event, and process it
@@ -301,6 +564,24 @@ int StaticClusteringWMS::main() {
         if (this->getWorkflow()->isDone()) {
             break;
         }
+
+        if (this->replan_needed) {
+            replan(jobs);
+            indexPendingJobs(jobs);
+        }
+    }
+
+    std::cout << "#REPLANS=" << this->num_replans << " (" << this->replan_cpu_time << " CPU seconds)\n";
+    Globals::sim_json["num_replans"] = this->num_replans;
+    Globals::sim_json["replan_cpu_time"] = this->replan_cpu_time;
+    if (Globals::staging_bandwidth > 0) {
+        std::cout << "#STAGED_BYTES=" << this->staged_bytes << " (" << this->staging_time << " seconds)\n";
+        Globals::sim_json["staged_bytes"] = this->staged_bytes;
+        Globals::sim_json["staging_time"] = this->staging_time;
+    }
+    if (Globals::static_lookahead) {
+        std::cout << "#LOOKAHEAD_JOBS=" << this->num_lookahead_jobs << "\n";
+        Globals::sim_json["num_lookahead_jobs"] = this->num_lookahead_jobs;
     }
 
 //  std::cout << "WORKFLOW EXECUTION COMPLETE: " <<  this->simulation->getCurrentSimulatedDate() << "\n";
@@ -309,33 +590,45 @@ int StaticClusteringWMS::main() {
     return 0;
 }
 
-void StaticClusteringWMS::submitClusteredJob(ClusteredJob *clustered_job) {
-
-    // Compute the maximum (reasonable) number of nodes for the job
-    unsigned long num_nodes = std::min<unsigned long>(clustered_job->getMaxParallelism(), clustered_job->getNumNodes());
-
-    if (num_nodes == 0) {
-        num_nodes = clustered_job->computeBestNumNodesBasedOnQueueWaitTimePredictions(
-                std::min<unsigned long>(clustered_job->getMaxParallelism(), this->number_of_nodes), this->core_speed, this->batch_service);
-    }
-
-    // For one_job-max
-    if (clustered_job->getNumNodes() == 100000) {
-        num_nodes = std::min<unsigned long>(clustered_job->getMaxParallelism(), this->number_of_nodes);
+/**
+ * @brief Submit a clustered job as one batch job, or as several staggered ones (--staggered-jobs)
+ * @param clustered_job: the clustered job
+ * @param max_num_batch_jobs: the maximum number of batch jobs it may be split into (the free job slots)
+ * @return the number of batch jobs submitted
+ */
+unsigned long StaticClusteringWMS::submitClusteredJob(ClusteredJob *clustered_job, unsigned long max_num_batch_jobs) {
+
+    unsigned long num_nodes = computeNumNodes(clustered_job);
+
+    // Release the nodes that run out of work early by submitting narrower, longer jobs for the tail
+    max_num_batch_jobs = std::min<unsigned long>(max_num_batch_jobs, Globals::max_staggered_jobs);
+    if (max_num_batch_jobs > 1) {
+        clustered_job->setNumNodes(num_nodes, clustered_job->isNumNodesBasedOnQueueWaitTimePrediction());
+        std::vector<ClusteredJob *> staggered_jobs = clustered_job->getStaggeredJobs(this->core_speed,
+                                                                                     max_num_batch_jobs);
+        if (staggered_jobs.size() > 1) {
+            for (auto staggered_job : staggered_jobs) {
+                submitClusteredJob(staggered_job);
+            }
+            return staggered_jobs.size();
+        }
     }
 
-    num_nodes = std::min<unsigned long>(num_nodes, this->number_of_nodes);
-    
     double makespan = WorkflowUtil::estimateMakespan(clustered_job->getTasks(), num_nodes, this->core_speed);
     // std::cout << "MAKESPAN ESTIMATE = " << makespan << "\n";
 
     std::map<std::string, std::string> batch_job_args;
     batch_job_args["-N"] = std::to_string(num_nodes);
     batch_job_args["-t"] = std::to_string(
-            (unsigned long) (1 + (makespan * EXECUTION_TIME_FUDGE_FACTOR) / 60.0)); //time in minutes
+            (unsigned long) (1 + (makespan * WorkflowUtil::getWalltimeFactor(clustered_job->getTasks(), num_nodes,
+                                                                             this->core_speed)) / 60.0)); //time in minutes
     batch_job_args["-c"] = "1"; //number of cores per node
 
-    auto standard_job = this->job_manager->createStandardJob(clustered_job->getTasks(), {});
+    auto standard_job = this->job_manager->createStandardJob(addStagingTasks(clustered_job->getTasks()), {});
+    if (Globals::replan_margin > 0) {
+        this->predicted_wait_times[standard_job.get()] =
+                predictWaitTime(num_nodes, 60.0 * std::stod(batch_job_args["-t"]));
+    }
     WRENCH_INFO("Created a batch job with with batch arguments: %s:%s:%s",
                 batch_job_args["-N"].c_str(),
                 batch_job_args["-t"].c_str(),
@@ -350,6 +643,471 @@ void StaticClusteringWMS::submitClusteredJob(ClusteredJob *clustered_job) {
         throw std::runtime_error("Couldn't submit job: " + e.getCause()->toString());
     }
 
+    return 1;
+}
+
+/**
+ * @brief Add to the workflow a task that stages in the input files of a job's tasks before they start, and one
+ *        that stages out their output files after they complete and before the tasks that read them start
+ *        (--staging-bandwidth)
+ * @param tasks: the job's tasks
+ * @return the job's tasks, with the staging tasks
+ */
+std::vector<WorkflowTask *> StaticClusteringWMS::addStagingTasks(std::vector<WorkflowTask *> tasks) {
+    if (Globals::staging_bandwidth <= 0) {
+        return tasks;
+    }
+    std::pair<double, double> staged_bytes = WorkflowUtil::getStagedBytes(tasks);
+    std::set<WorkflowTask *> job_tasks(tasks.begin(), tasks.end());
+    Workflow *workflow = this->getWorkflow();
+    std::vector<WorkflowTask *> tasks_with_staging;
+
+    if (staged_bytes.first > 0) {
+        double flops = staged_bytes.first / Globals::staging_bandwidth * this->core_speed;
+        auto stage_in_task = workflow->addTask("stage_in_" + std::to_string(Simulator::sequence_number++),
+                                               flops, 1, 1, 1.0);
+        for (auto t : tasks) {
+            bool has_parent_in_job = false;
+            for (auto parent : workflow->getTaskParents(t)) {
+                has_parent_in_job |= (job_tasks.find(parent) != job_tasks.end());
+            }
+            if (not has_parent_in_job) {
+                workflow->addControlDependency(stage_in_task, t);
+            }
+        }
+        this->staging_tasks.insert(stage_in_task);
+        tasks_with_staging.push_back(stage_in_task);
+    }
+
+    tasks_with_staging.insert(tasks_with_staging.end(), tasks.begin(), tasks.end());
+
+    if (staged_bytes.second > 0) {
+        double flops = staged_bytes.second / Globals::staging_bandwidth * this->core_speed;
+        auto stage_out_task = workflow->addTask("stage_out_" + std::to_string(Simulator::sequence_number++),
+                                                flops, 1, 1, 1.0);
+        for (auto t : tasks) {
+            bool has_child_in_job = false;
+            for (auto child : workflow->getTaskChildren(t)) {
+                if (job_tasks.find(child) != job_tasks.end()) {
+                    has_child_in_job = true;
+                } else {
+                    workflow->addControlDependency(stage_out_task, child);
+                }
+            }
+            if (not has_child_in_job) {
+                workflow->addControlDependency(t, stage_out_task);
+            }
+        }
+        this->staging_tasks.insert(stage_out_task);
+        tasks_with_staging.push_back(stage_out_task);
+    }
+
+    this->staged_bytes += staged_bytes.first + staged_bytes.second;
+    this->staging_time += (staged_bytes.first + staged_bytes.second) / Globals::staging_bandwidth;
+    return tasks_with_staging;
+}
+
+/**
+ * @brief Compute the maximum (reasonable) number of nodes for a clustered job
+ * @param clustered_job: the clustered job
+ * @return a number of nodes
+ */
+unsigned long StaticClusteringWMS::computeNumNodes(ClusteredJob *clustered_job) {
+    unsigned long num_nodes = std::min<unsigned long>(clustered_job->getMaxParallelism(), clustered_job->getNumNodes());
+
+    if (num_nodes == 0) {
+        num_nodes = clustered_job->computeBestNumNodesBasedOnQueueWaitTimePredictions(
+                std::min<unsigned long>(clustered_job->getMaxParallelism(), this->number_of_nodes), this->core_speed, this->batch_service);
+    }
+
+    // For one_job-max
+    if (clustered_job->getNumNodes() == 100000) {
+        num_nodes = std::min<unsigned long>(clustered_job->getMaxParallelism(), this->number_of_nodes);
+    }
+
+    return std::min<unsigned long>(num_nodes, this->number_of_nodes);
+}
+
+/**
+ * @brief Get the priority of a clustered job: the longest path from the start of one of its tasks to the end
+ *        of the workflow
+ * @param clustered_job: the clustered job
+ * @return a duration, in seconds
+ */
+double StaticClusteringWMS::getPriority(ClusteredJob *clustered_job) {
+    double priority = 0;
+    for (auto t : clustered_job->getTasks()) {
+        priority = std::max<double>(priority, this->bottom_levels[t]);
+    }
+    return priority;
+}
+
+/**
+ * @brief Sort clustered jobs by decreasing priority, ties being broken by the ID of their first task
+ * @param clustered_jobs: the clustered jobs
+ * @return the sorted clustered jobs
+ */
+std::vector<ClusteredJob *> StaticClusteringWMS::sortByPriority(std::vector<ClusteredJob *> clustered_jobs) {
+    std::vector<std::pair<double, ClusteredJob *>> prioritized_jobs;
+    for (auto j : clustered_jobs) {
+        prioritized_jobs.push_back(std::make_pair(getPriority(j), j));
+    }
+    std::sort(prioritized_jobs.begin(), prioritized_jobs.end(),
+              [](const std::pair<double, ClusteredJob *> &j1, const std::pair<double, ClusteredJob *> &j2) -> bool {
+                  if (j1.first == j2.first) {
+                      return j1.second->getTasks().at(0)->getID() < j2.second->getTasks().at(0)->getID();
+                  }
+                  return j1.first > j2.first;
+              });
+
+    std::vector<ClusteredJob *> sorted_jobs;
+    for (auto const &j : prioritized_jobs) {
+        sorted_jobs.push_back(j.second);
+    }
+    return sorted_jobs;
+}
+
+/**
+ * @brief Index the jobs that haven't been submitted by task, and queue those that are ready (when the set of
+ *        these jobs changes other than by submissions, i.e., initially, after a re-plan, or when lookahead jobs expire)
+ * @param jobs: the clustered jobs that haven't been submitted
+ */
+void StaticClusteringWMS::indexPendingJobs(std::set<ClusteredJob *> &jobs) {
+    this->ready_jobs.clear();
+    this->pending_job_of_task.clear();
+    for (auto j : jobs) {
+        for (auto t : j->getTasks()) {
+            this->pending_job_of_task[t] = j;
+        }
+        enqueueIfReady(j);
+    }
+}
+
+/**
+ * @brief Queue a job that hasn't been submitted if it is ready
+ * @param clustered_job: the clustered job
+ */
+void StaticClusteringWMS::enqueueIfReady(ClusteredJob *clustered_job) {
+    if (clustered_job->isReady()) {
+        this->ready_jobs.insert(std::make_tuple(-getPriority(clustered_job),
+                                                clustered_job->getTasks().at(0)->getID(), clustered_job));
+    }
+}
+
+/**
+ * @brief Estimate the time until the tasks of a job that isn't ready have their inputs, if they only wait
+ *        for running tasks
+ * @param clustered_job: the clustered job
+ * @return a duration, in seconds, or -1 if a task waits for a task that hasn't started
+ */
+double StaticClusteringWMS::getParentsRemainingTime(ClusteredJob *clustered_job) {
+    std::vector<WorkflowTask *> tasks = clustered_job->getTasks();
+    std::set<WorkflowTask *> own_tasks(tasks.begin(), tasks.end());
+
+    double remaining_time = -1;
+    for (auto t : tasks) {
+        for (auto p : this->getWorkflow()->getTaskParents(t)) {
+            if ((own_tasks.find(p) != own_tasks.end()) or (p->getState() == WorkflowTask::COMPLETED)) {
+                continue;
+            }
+            if ((p->getState() != WorkflowTask::PENDING) or (p->getStartDate() < 0)) {
+                return -1;
+            }
+            remaining_time = std::max<double>(
+                    remaining_time, std::max<double>(0, p->getStartDate() + WorkflowUtil::getNominalFlops(p) / this->core_speed -
+                                                        this->simulation->getCurrentSimulatedDate()));
+        }
+    }
+    return remaining_time;
+}
+
+/**
+ * @brief Submit, as pilot jobs, the jobs that aren't ready but only wait for running tasks, and whose
+ *        predicted queue wait exceeds the remaining runtime of these tasks (--static-lookahead)
+ * @param jobs: the clustered jobs that haven't been submitted (updated)
+ */
+void StaticClusteringWMS::submitLookaheadJobs(std::set<ClusteredJob *> &jobs) {
+    std::vector<ClusteredJob *> waiting_jobs;
+    for (auto j : jobs) {
+        if (not j->isReady()) {
+            waiting_jobs.push_back(j);
+        }
+    }
+
+    for (auto clustered_job : sortByPriority(waiting_jobs)) {
+        if (this->num_jobs_in_systems >= this->max_num_jobs) {
+            break;
+        }
+        double parents_remaining_time = getParentsRemainingTime(clustered_job);
+        if (parents_remaining_time < 0) {
+            continue;
+        }
+
+        unsigned long num_nodes = computeNumNodes(clustered_job);
+        double makespan = WorkflowUtil::estimateMakespan(clustered_job->getTasks(), num_nodes, this->core_speed) *
+                          WorkflowUtil::getWalltimeFactor(clustered_job->getTasks(), num_nodes, this->core_speed);
+        // The job would start after its inputs are ready, so the makespan is all it needs
+        unsigned long requested_minutes = (unsigned long) (1 + makespan / 60.0);
+        if (predictWaitTime(num_nodes, 60.0 * requested_minutes) <= parents_remaining_time) {
+            continue;
+        }
+
+        clustered_job->setNumNodes(num_nodes, clustered_job->isNumNodesBasedOnQueueWaitTimePrediction());
+        unsigned long start_level = ULONG_MAX;
+        unsigned long end_level = 0;
+        for (auto t : clustered_job->getTasks()) {
+            start_level = std::min<unsigned long>(start_level, t->getTopLevel());
+            end_level = std::max<unsigned long>(end_level, t->getTopLevel());
+        }
+        auto placeholder_job = new PlaceHolderJob(this->job_manager->createPilotJob(), clustered_job,
+                                                  start_level, end_level);
+
+        std::map<std::string, std::string> service_specific_args;
+        service_specific_args["-N"] = std::to_string(num_nodes);
+        service_specific_args["-c"] = "1";
+        service_specific_args["-t"] = std::to_string(requested_minutes);
+        try {
+            this->job_manager->submitJob(placeholder_job->pilot_job, this->batch_service, service_specific_args);
+        } catch (WorkflowExecutionException &e) {
+            throw std::runtime_error("Couldn't submit lookahead job: " + e.getCause()->toString());
+        }
+        WRENCH_INFO("Submitted lookahead job %s (%s hosts, %s min), whose parents need %.2lf more seconds",
+                    placeholder_job->pilot_job->getName().c_str(),
+                    service_specific_args["-N"].c_str(), service_specific_args["-t"].c_str(),
+                    parents_remaining_time);
+
+        this->lookahead_placeholder_jobs.insert(placeholder_job);
+        jobs.erase(clustered_job);
+        this->num_jobs_in_systems++;
+        this->num_lookahead_jobs++;
+    }
+}
+
+/**
+ * @brief Submit the ready tasks of a running lookahead job to its pilot job, each in its standard job
+ * @param placeholder_job: the lookahead job
+ */
+void StaticClusteringWMS::dispatchLookaheadTasks(PlaceHolderJob *placeholder_job) {
+    WorkflowTask *task;
+    while ((task = placeholder_job->popReadyTask()) != nullptr) {
+        auto standard_job = this->job_manager->createStandardJob(task, {});
+        WRENCH_INFO("Submitting task %s to lookahead job %s", task->getID().c_str(),
+                    placeholder_job->pilot_job->getName().c_str());
+        this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
+        this->lookahead_standard_jobs[standard_job.get()] = placeholder_job;
+        placeholder_job->num_standard_job_submitted++;
+    }
+}
+
+/**
+ * @brief Terminate a lookahead job whose tasks have all completed, and account for its wasted node time
+ * @param placeholder_job: the lookahead job
+ */
+void StaticClusteringWMS::terminateLookaheadJob(PlaceHolderJob *placeholder_job) {
+    ulong num_used_nodes;
+    sscanf(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"].c_str(), "%lu", &num_used_nodes);
+    double wasted_node_seconds =
+            num_used_nodes * (this->simulation->getCurrentSimulatedDate() - placeholder_job->start_date);
+    for (auto t : placeholder_job->tasks) {
+        wasted_node_seconds -= t->getFlops() / this->core_speed;
+    }
+    this->simulator->wasted_node_seconds += wasted_node_seconds;
+
+    WRENCH_INFO("All tasks of lookahead job %s have completed, so I am terminating it",
+                placeholder_job->pilot_job->getName().c_str());
+    try {
+        this->job_manager->terminateJob(placeholder_job->pilot_job);
+    } catch (WorkflowExecutionException &e) {
+        // ignore
+    }
+    this->lookahead_placeholder_jobs.erase(placeholder_job);
+    delete placeholder_job;
+    this->num_jobs_in_systems--;
+}
+
+/**
+ * @brief Scale a cluster size parameter (number of tasks or seconds per cluster) by the factor that re-planning
+ *        adjusts as queue waits drift from their predictions
+ * @param size: the cluster size in the algorithm spec
+ * @return the cluster size to use (at least 1)
+ */
+unsigned long StaticClusteringWMS::scaleClusterSize(unsigned long size) {
+    return std::max<unsigned long>(1, (unsigned long) std::round(size * this->cluster_size_factor));
+}
+
+/**
+ * @brief Scale a number of seconds per cluster like scaleClusterSize(), without going below the longest task of
+ *        the levels to cluster: the dfjs, dfjs_bfd and locality methods reject tasks longer than a cluster
+ * @param num_seconds: the number of seconds per cluster in the algorithm spec
+ * @param start_level: the first level to cluster
+ * @param end_level: the last level to cluster
+ * @return the number of seconds per cluster to use
+ */
+unsigned long StaticClusteringWMS::scaleClusterDuration(unsigned long num_seconds, unsigned long start_level,
+                                                        unsigned long end_level) {
+    unsigned long scaled = scaleClusterSize(num_seconds);
+    if (scaled >= num_seconds) {
+        return scaled;
+    }
+    unsigned long longest_task = 0;
+    for (auto t : this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level)) {
+        longest_task = std::max<unsigned long>(
+                longest_task, (unsigned long) (ceil(WorkflowUtil::getNominalFlops(t) / this->core_speed)));
+    }
+    // A spec whose bound is already below the longest task fails as it would without re-planning
+    return std::max<unsigned long>(scaled, std::min<unsigned long>(num_seconds, longest_task));
+}
+
+/**
+ * @brief Get the batch service's prediction of the queue wait of a job submitted now
+ * @param num_nodes: the job's number of nodes
+ * @param requested_time: the job's requested time, in seconds
+ * @return a wait time, in seconds
+ */
+double StaticClusteringWMS::predictWaitTime(unsigned long num_nodes, double requested_time) {
+    std::string job_id = "static_tentative_job_" + std::to_string(Simulator::sequence_number++);
+    std::set<std::tuple<std::string, unsigned long, unsigned long, double>> job_configurations;
+    job_configurations.insert(std::make_tuple(job_id, num_nodes, 1, requested_time));
+
+    std::map<std::string, double> estimates;
+    try {
+        estimates = this->batch_service->getStartTimeEstimates(job_configurations);
+    } catch (WorkflowExecutionException &e) {
+        throw std::runtime_error(std::string("Couldn't acquire queue wait time predictions: ") + e.what());
+    }
+    return std::max<double>(0, estimates[job_id] - this->simulation->getCurrentSimulatedDate());
+}
+
+/**
+ * @brief Re-cluster the jobs that haven't been submitted, from the first level whose tasks are all in such
+ *        jobs, with the cluster sizes scaled by the current factor (hc, dfjs, dfjs_bfd, locality, hrb, hifb
+ *        and hdb methods only)
+ * @param jobs: the clustered jobs that haven't been submitted (updated)
+ */
+void StaticClusteringWMS::replan(std::set<ClusteredJob *> &jobs) {
+    this->replan_needed = false;
+
+    // Staging tasks have changed the levels of the workflow
+    if (not this->staging_tasks.empty()) {
+        return;
+    }
+
+    std::string method = this->algorithm_spec.substr(0, this->algorithm_spec.find('-'));
+    if ((method != "hc") and (method != "dfjs") and (method != "dfjs_bfd") and (method != "locality") and (method != "hrb") and (method != "hifb") and (method != "hdb")) {
+        return;
+    }
+
+    std::clock_t cpu_start = std::clock();
+
+    // Find the first level whose tasks haven't been submitted
+    std::set<WorkflowTask *> unsubmitted_tasks;
+    for (auto j : jobs) {
+        for (auto t : j->getTasks()) {
+            unsubmitted_tasks.insert(t);
+        }
+    }
+    unsigned long start_level = 0;
+    for (auto t : this->getWorkflow()->getTasks()) {
+        if (unsubmitted_tasks.find(t) == unsubmitted_tasks.end()) {
+            start_level = std::max<unsigned long>(start_level, t->getTopLevel() + 1);
+        }
+    }
+
+    // Jobs with tasks before that level stay as they are, and so do all the levels of their tasks
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        for (auto j : jobs) {
+            unsigned long min_level = ULONG_MAX;
+            unsigned long max_level = 0;
+            for (auto t : j->getTasks()) {
+                min_level = std::min<unsigned long>(min_level, t->getTopLevel());
+                max_level = std::max<unsigned long>(max_level, t->getTopLevel());
+            }
+            if ((min_level < start_level) and (max_level >= start_level)) {
+                start_level = max_level + 1;
+                moved = true;
+            }
+        }
+    }
+
+    if (start_level < this->getWorkflow()->getNumLevels()) {
+        // Re-cluster before dropping the current jobs, so that the current plan stays if the new one can't be made
+        std::set<ClusteredJob *> new_jobs;
+        try {
+            new_jobs = createClusteredJobs(start_level);
+        } catch (std::runtime_error &e) {
+            WRENCH_INFO("Couldn't re-cluster levels %lu and up, keeping the current jobs: %s", start_level, e.what());
+            this->replan_cpu_time += (double) (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            return;
+        }
+        for (auto it = jobs.begin(); it != jobs.end();) {
+            if ((*it)->getTasks().at(0)->getTopLevel() >= start_level) {
+                delete *it;
+                it = jobs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto j : new_jobs) {
+            jobs.insert(j);
+        }
+        this->num_replans++;
+
+        WRENCH_INFO("Re-clustered levels %lu and up, with cluster sizes scaled by %.2lf (%lu jobs left to submit)",
+                    start_level, this->cluster_size_factor, jobs.size());
+    }
+
+    this->replan_cpu_time += (double) (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+}
+
+/**
+ * @brief Check whether a clustered job can be part of a job array, i.e., whether it is a single-node, single-task job
+ * @param clustered_job: the clustered job
+ * @return true or false
+ */
+bool StaticClusteringWMS::isJobArrayElement(ClusteredJob *clustered_job) {
+    return (clustered_job->getNumTasks() == 1) and (clustered_job->getNumNodes() == 1);
+}
+
+/**
+ * @brief Get the requested time of a single-node, single-task job, in minutes (as in submitClusteredJob())
+ * @param clustered_job: the clustered job
+ * @return a number of minutes
+ */
+unsigned long StaticClusteringWMS::getJobArrayElementRequestedMinutes(ClusteredJob *clustered_job) {
+    double makespan = WorkflowUtil::estimateMakespan(clustered_job->getTasks(), 1, this->core_speed);
+    return (unsigned long) (1 + (makespan * WorkflowUtil::getWalltimeFactor(clustered_job->getTasks(), 1,
+                                                                            this->core_speed)) / 60.0);
+}
+
+/**
+ * @brief Submit a single-node, single-task job as a job array, along with the other ready such jobs that
+ *        request the same time
+ * @param clustered_job: the clustered job (ready)
+ * @param jobs: the clustered jobs that haven't been submitted (updated)
+ */
+void StaticClusteringWMS::submitJobArray(ClusteredJob *clustered_job, std::set<ClusteredJob *> &jobs) {
+    unsigned long requested_minutes = getJobArrayElementRequestedMinutes(clustered_job);
+
+    std::vector<WorkflowTask *> tasks = {clustered_job->getTasks().at(0)};
+    jobs.erase(clustered_job);
+    for (auto it = jobs.begin(); (it != jobs.end()) and (tasks.size() < Globals::max_job_array_size);) {
+        ClusteredJob *other_job = *it;
+        if (isJobArrayElement(other_job) and other_job->isReady() and
+            (getJobArrayElementRequestedMinutes(other_job) == requested_minutes)) {
+            tasks.push_back(other_job->getTasks().at(0));
+            it = jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    try {
+        this->job_arrays.submit(this->job_manager, this->batch_service, tasks, requested_minutes);
+    } catch (WorkflowExecutionException &e) {
+        throw std::runtime_error("Couldn't submit job array: " + e.getCause()->toString());
+    }
 }
 
 std::set<ClusteredJob *> StaticClusteringWMS::createHCJobs(
@@ -408,7 +1166,7 @@ std::set<ClusteredJob *> StaticClusteringWMS::createDFJSJobs(
         auto job = new ClusteredJob();
         job->setNumNodes(num_nodes_per_cluster);
         for (auto t : tasks_in_level) {
-            auto task_execution_time = (unsigned long) (ceil(t->getFlops() / core_speed));
+            auto task_execution_time = (unsigned long) (ceil(WorkflowUtil::getNominalFlops(t) / core_speed));
             if (task_execution_time > num_seconds_per_cluster) {
                 throw std::runtime_error(
                         "Task " + t->getID() + " by itself takes longer (" + std::to_string(task_execution_time) +
@@ -447,6 +1205,326 @@ std::set<ClusteredJob *> StaticClusteringWMS::createDFJSJobs(
     return jobs;
 }
 
+/**
+ * @brief Pack tasks into clusters as DFJS does: each task goes to the current cluster if the estimated makespan
+ *        of the cluster stays within the bound, and starts a new cluster otherwise
+ * @param tasks: the tasks, in packing order
+ * @param num_nodes_per_cluster: the number of hosts used to execute each cluster
+ * @param num_seconds_per_cluster: the bound on the runtime of each cluster
+ * @param core_speed: the core speed
+ * @return the tasks of each cluster
+ */
+std::vector<std::vector<WorkflowTask *>> StaticClusteringWMS::packDFJSClusters(
+        std::vector<WorkflowTask *> tasks, unsigned long num_nodes_per_cluster, unsigned long num_seconds_per_cluster,
+        double core_speed) {
+    std::vector<std::vector<WorkflowTask *>> clusters(1);
+    for (auto t : tasks) {
+        std::vector<WorkflowTask *> tentative_tasks = clusters.back();
+        tentative_tasks.push_back(t);
+        double estimated_makespan = WorkflowUtil::estimateMakespan(tentative_tasks, num_nodes_per_cluster,
+                                                                   core_speed);
+        if (clusters.back().empty() or ((unsigned long) (ceil(estimated_makespan)) <= num_seconds_per_cluster)) {
+            clusters.back().push_back(t);
+        } else {
+            clusters.push_back({t});
+        }
+    }
+    return clusters;
+}
+
+/**
+ * @brief A best-fit-decreasing variant of DFJS: each cluster of a level is seen as m hosts that can each run
+ *        tasks for the runtime bound, and each task, longest first, goes to the least loaded host of the
+ *        cluster whose least loaded host would be left with the least spare time. Since the host loads ignore
+ *        dependencies and staging, each cluster is then checked with WorkflowUtil::estimateMakespan() as in
+ *        DFJS, and split in the order its tasks were packed if its estimate exceeds the bound
+ * @param vc: the application of vertical clustering (vprior, vposterior, or vnone)
+ * @param num_seconds_per_cluster: the bound on the runtime of each cluster
+ * @param num_nodes_per_cluster: the number of hosts used to execute each cluster (with 0, clusters are packed
+ *        for one host, and the number of hosts is picked based on queue wait time predictions at submission)
+ * @param core_speed: the core speed
+ * @param workflow: the workflow
+ * @param start_level: the first level to cluster
+ * @param end_level: the last level to cluster
+ * @return the clustered jobs
+ */
+std::set<ClusteredJob *> StaticClusteringWMS::createDFJSBFDJobs(
+        std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
+        double core_speed,
+        Workflow *workflow, unsigned long start_level, unsigned long end_level) {
+    std::set<ClusteredJob *> jobs;
+
+    if (vc == "vprior") {
+        mergeSingleParentSingleChildPairs(workflow);
+    }
+
+    unsigned long num_hosts = std::max<unsigned long>(1, num_nodes_per_cluster);
+    double bound = num_seconds_per_cluster;
+
+    // For comparison with DFJS, which fills clusters in level order (with the same number of hosts)
+    unsigned long num_dfjs_clusters = 0;
+    unsigned long num_split_clusters = 0;
+    double total_estimated_makespan = 0;
+    double total_dfjs_estimated_makespan = 0;
+
+    // Go through each level and creates jobs
+    for (unsigned long l = start_level; l <= end_level; l++) {
+        auto tasks_in_level = workflow->getTasksInTopLevelRange(l, l);
+
+        std::vector<double> runtimes;
+        for (auto t : tasks_in_level) {
+            auto task_execution_time = (unsigned long) (ceil(WorkflowUtil::getNominalFlops(t) / core_speed));
+            if (task_execution_time > num_seconds_per_cluster) {
+                throw std::runtime_error(
+                        "Task " + t->getID() + " by itself takes longer (" + std::to_string(task_execution_time) +
+                        " sec) than the cluster duration upper bound ( " +
+                        std::to_string(num_seconds_per_cluster) + " sec)!");
+            }
+            runtimes.push_back((double) task_execution_time);
+        }
+
+        // DFJS
+        if (not tasks_in_level.empty()) {
+            for (auto const &cluster : packDFJSClusters(tasks_in_level, num_hosts, num_seconds_per_cluster,
+                                                        core_speed)) {
+                num_dfjs_clusters++;
+                total_dfjs_estimated_makespan += WorkflowUtil::estimateMakespan(cluster, num_hosts, core_speed);
+            }
+        }
+
+        // Sort the tasks by decreasing runtime
+        std::vector<unsigned long> order;
+        for (unsigned long i = 0; i < tasks_in_level.size(); i++) {
+            order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(),
+                  [&runtimes, &tasks_in_level](const unsigned long i1, const unsigned long i2) -> bool {
+                      if (runtimes[i1] == runtimes[i2]) {
+                          return (tasks_in_level[i1]->getID() < tasks_in_level[i2]->getID());
+                      }
+                      return (runtimes[i1] > runtimes[i2]);
+                  });
+
+        // The clusters of the level, their host loads (min-heaps), and the clusters indexed by the load of
+        // their least loaded host, so that the best fit is found in O(log k)
+        std::vector<ClusteredJob *> level_jobs;
+        std::vector<std::priority_queue<double, std::vector<double>, std::greater<double>>> level_host_loads;
+        std::set<std::pair<double, unsigned long>> clusters_by_least_load;
+
+        for (auto i : order) {
+            double runtime = runtimes[i];
+            auto best_fit = clusters_by_least_load.upper_bound(std::make_pair(bound - runtime, ULONG_MAX));
+            unsigned long c;
+            if (best_fit == clusters_by_least_load.begin()) {
+                c = level_jobs.size();
+                auto job = new ClusteredJob();
+                job->setNumNodes(num_nodes_per_cluster);
+                level_jobs.push_back(job);
+                level_host_loads.push_back(std::priority_queue<double, std::vector<double>, std::greater<double>>(
+                        std::greater<double>(), std::vector<double>(num_hosts, 0)));
+            } else {
+                --best_fit;
+                c = best_fit->second;
+                clusters_by_least_load.erase(best_fit);
+            }
+
+            double load = level_host_loads[c].top() + runtime;
+            level_host_loads[c].pop();
+            level_host_loads[c].push(load);
+            clusters_by_least_load.insert(std::make_pair(level_host_loads[c].top(), c));
+            level_jobs[c]->addTask(tasks_in_level[i]);
+        }
+
+        // Check each cluster with the makespan estimate that DFJS uses, and split those that exceed the bound
+        for (auto job : level_jobs) {
+            double estimated_makespan = WorkflowUtil::estimateMakespan(job->getTasks(), num_hosts, core_speed);
+            if ((unsigned long) (ceil(estimated_makespan)) <= num_seconds_per_cluster) {
+                jobs.insert(job);
+                total_estimated_makespan += estimated_makespan;
+                continue;
+            }
+            num_split_clusters++;
+            for (auto const &cluster : packDFJSClusters(job->getTasks(), num_hosts, num_seconds_per_cluster,
+                                                        core_speed)) {
+                auto split_job = new ClusteredJob();
+                split_job->setNumNodes(num_nodes_per_cluster);
+                for (auto t : cluster) {
+                    split_job->addTask(t);
+                }
+                jobs.insert(split_job);
+                total_estimated_makespan += WorkflowUtil::estimateMakespan(cluster, num_hosts, core_speed);
+            }
+            delete job;
+        }
+    }
+
+    Globals::sim_json["dfjs_bfd"]["num_clusters"] = jobs.size();
+    Globals::sim_json["dfjs_bfd"]["num_dfjs_clusters"] = num_dfjs_clusters;
+    Globals::sim_json["dfjs_bfd"]["num_split_clusters"] = num_split_clusters;
+    Globals::sim_json["dfjs_bfd"]["total_estimated_makespan"] = total_estimated_makespan;
+    Globals::sim_json["dfjs_bfd"]["total_dfjs_estimated_makespan"] = total_dfjs_estimated_makespan;
+    WRENCH_INFO("DFJS best-fit-decreasing clustering: %ld clusters (%ld with DFJS)", jobs.size(), num_dfjs_clusters);
+
+    if (vc == "vposterior") {
+        jobs = applyPosteriorVC(workflow, jobs);
+    }
+
+    return jobs;
+}
+
+/**
+ * @brief Cluster tasks in each level so that tasks that read the same files are in the same job, which then
+ *        stages these files in once: each task, longest first, goes to the cluster (seen as m hosts that can
+ *        each run tasks for the runtime bound, as with dfjs_bfd) that already reads the most bytes of its
+ *        input files, or else to the cluster it fits best. As with dfjs_bfd, each cluster is then checked with
+ *        WorkflowUtil::estimateMakespan(), which includes staging, and split if its estimate exceeds the bound
+ * @param vc: the application of vertical clustering (vprior, vposterior, or vnone)
+ * @param num_seconds_per_cluster: the bound on the runtime of each cluster
+ * @param num_nodes_per_cluster: the number of hosts used to execute each cluster (with 0, clusters are packed
+ *        for one host, and the number of hosts is picked based on queue wait time predictions at submission)
+ * @param core_speed: the core speed
+ * @param workflow: the workflow
+ * @param start_level: the first level to cluster
+ * @param end_level: the last level to cluster
+ * @return the clustered jobs
+ */
+std::set<ClusteredJob *> StaticClusteringWMS::createLocalityJobs(
+        std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
+        double core_speed,
+        Workflow *workflow, unsigned long start_level, unsigned long end_level) {
+    std::set<ClusteredJob *> jobs;
+
+    if (vc == "vprior") {
+        mergeSingleParentSingleChildPairs(workflow);
+    }
+
+    unsigned long num_hosts = std::max<unsigned long>(1, num_nodes_per_cluster);
+    double bound = num_seconds_per_cluster;
+    unsigned long num_split_clusters = 0;
+
+    // Go through each level and creates jobs
+    for (unsigned long l = start_level; l <= end_level; l++) {
+        auto tasks_in_level = workflow->getTasksInTopLevelRange(l, l);
+
+        std::vector<double> runtimes;
+        for (auto t : tasks_in_level) {
+            auto task_execution_time = (unsigned long) (ceil(WorkflowUtil::getNominalFlops(t) / core_speed));
+            if (task_execution_time > num_seconds_per_cluster) {
+                throw std::runtime_error(
+                        "Task " + t->getID() + " by itself takes longer (" + std::to_string(task_execution_time) +
+                        " sec) than the cluster duration upper bound ( " +
+                        std::to_string(num_seconds_per_cluster) + " sec)!");
+            }
+            runtimes.push_back((double) task_execution_time);
+        }
+
+        // Sort the tasks by decreasing runtime
+        std::vector<unsigned long> order;
+        for (unsigned long i = 0; i < tasks_in_level.size(); i++) {
+            order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(),
+                  [&runtimes, &tasks_in_level](const unsigned long i1, const unsigned long i2) -> bool {
+                      if (runtimes[i1] == runtimes[i2]) {
+                          return (tasks_in_level[i1]->getID() < tasks_in_level[i2]->getID());
+                      }
+                      return (runtimes[i1] > runtimes[i2]);
+                  });
+
+        // The clusters of the level, their host loads (min-heaps), the clusters indexed by the load of their
+        // least loaded host, and the clusters that read each file
+        std::vector<ClusteredJob *> level_jobs;
+        std::vector<std::priority_queue<double, std::vector<double>, std::greater<double>>> level_host_loads;
+        std::set<std::pair<double, unsigned long>> clusters_by_least_load;
+        std::map<std::string, std::set<unsigned long>> file_readers;
+
+        for (auto i : order) {
+            double runtime = runtimes[i];
+            std::vector<std::pair<std::string, double>> input_files =
+                    WorkflowUtil::getInputFiles(tasks_in_level[i]);
+
+            // The cluster that already reads the most bytes of the task's input files, if it fits
+            std::map<unsigned long, double> shared_bytes;
+            for (auto const &f : input_files) {
+                for (auto c : file_readers[f.first]) {
+                    shared_bytes[c] += f.second;
+                }
+            }
+            unsigned long c = ULONG_MAX;
+            double most_shared_bytes = 0;
+            for (auto const &cluster_shared_bytes : shared_bytes) {
+                if ((cluster_shared_bytes.second > most_shared_bytes) and
+                    (level_host_loads[cluster_shared_bytes.first].top() + runtime <= bound)) {
+                    c = cluster_shared_bytes.first;
+                    most_shared_bytes = cluster_shared_bytes.second;
+                }
+            }
+
+            // Otherwise, the best fit
+            if (c == ULONG_MAX) {
+                auto best_fit = clusters_by_least_load.upper_bound(std::make_pair(bound - runtime, ULONG_MAX));
+                if (best_fit != clusters_by_least_load.begin()) {
+                    --best_fit;
+                    c = best_fit->second;
+                }
+            }
+            if (c == ULONG_MAX) {
+                c = level_jobs.size();
+                auto job = new ClusteredJob();
+                job->setNumNodes(num_nodes_per_cluster);
+                level_jobs.push_back(job);
+                level_host_loads.push_back(std::priority_queue<double, std::vector<double>, std::greater<double>>(
+                        std::greater<double>(), std::vector<double>(num_hosts, 0)));
+            } else {
+                clusters_by_least_load.erase(std::make_pair(level_host_loads[c].top(), c));
+            }
+
+            double load = level_host_loads[c].top() + runtime;
+            level_host_loads[c].pop();
+            level_host_loads[c].push(load);
+            clusters_by_least_load.insert(std::make_pair(level_host_loads[c].top(), c));
+            level_jobs[c]->addTask(tasks_in_level[i]);
+            for (auto const &f : input_files) {
+                file_readers[f.first].insert(c);
+            }
+        }
+
+        // The host loads ignore dependencies and staging: check each cluster with the makespan estimate, and
+        // split those that exceed the bound
+        for (auto job : level_jobs) {
+            double estimated_makespan = WorkflowUtil::estimateMakespan(job->getTasks(), num_hosts, core_speed);
+            if ((unsigned long) (ceil(estimated_makespan)) <= num_seconds_per_cluster) {
+                jobs.insert(job);
+                continue;
+            }
+            num_split_clusters++;
+            for (auto const &cluster : packDFJSClusters(job->getTasks(), num_hosts, num_seconds_per_cluster,
+                                                        core_speed)) {
+                auto split_job = new ClusteredJob();
+                split_job->setNumNodes(num_nodes_per_cluster);
+                for (auto t : cluster) {
+                    split_job->addTask(t);
+                }
+                jobs.insert(split_job);
+            }
+            delete job;
+        }
+    }
+
+    if (vc == "vposterior") {
+        jobs = applyPosteriorVC(workflow, jobs);
+    }
+
+    double staged_bytes = 0;
+    for (auto job : jobs) {
+        std::pair<double, double> job_staged_bytes = WorkflowUtil::getStagedBytes(job->getTasks());
+        staged_bytes += job_staged_bytes.first + job_staged_bytes.second;
+    }
+    WRENCH_INFO("Locality-aware clustering: %ld clusters (%ld split), staging %.0lf bytes", jobs.size(),
+                num_split_clusters, staged_bytes);
+    return jobs;
+}
+
 
 std::set<ClusteredJob *> StaticClusteringWMS::createHRBJobs(
         std::string vc, unsigned long num_tasks_per_cluster, unsigned long num_nodes_per_cluster,
@@ -474,10 +1552,12 @@ std::set<ClusteredJob *> StaticClusteringWMS::createHRBJobs(
         // Sort the tasks by decreasing Flops
         std::sort(tasks_in_level.begin(), tasks_in_level.end(),
                   [](const wrench::WorkflowTask *t1, const wrench::WorkflowTask *t2) -> bool {
-                      if (fabs(t1->getFlops() - t2->getFlops()) < 0.001) {
+                      double flops1 = WorkflowUtil::getNominalFlops(t1);
+                      double flops2 = WorkflowUtil::getNominalFlops(t2);
+                      if (fabs(flops1 - flops2) < 0.001) {
                           return ((uintptr_t) t1 > (uintptr_t) t2);
                       } else {
-                          return (t1->getFlops() > t2->getFlops());
+                          return (flops1 > flops2);
                       }
                   });
 
@@ -567,10 +1647,12 @@ std::set<ClusteredJob *> StaticClusteringWMS::createHIFBJobs(
         std::sort(tasks_in_level.begin(), tasks_in_level.end(),
                   [](const wrench::WorkflowTask *t1, const wrench::WorkflowTask *t2) -> bool {
 
-                      if (fabs(t1->getFlops() - t2->getFlops()) < 0.001) {
+                      double flops1 = WorkflowUtil::getNominalFlops(t1);
+                      double flops2 = WorkflowUtil::getNominalFlops(t2);
+                      if (fabs(flops1 - flops2) < 0.001) {
                           return ((uintptr_t) t1 > (uintptr_t) t2);
                       } else {
-                          return (t1->getFlops() > t2->getFlops());
+                          return (flops1 > flops2);
                       }
                   });
 
@@ -747,10 +1829,12 @@ std::set<ClusteredJob *> StaticClusteringWMS::createHDBJobs(
         std::sort(tasks_in_level.begin(), tasks_in_level.end(),
                   [](const wrench::WorkflowTask *t1, const wrench::WorkflowTask *t2) -> bool {
 
-                      if (fabs(t1->getFlops() - t2->getFlops()) < 0.001) {
+                      double flops1 = WorkflowUtil::getNominalFlops(t1);
+                      double flops2 = WorkflowUtil::getNominalFlops(t2);
+                      if (fabs(flops1 - flops2) < 0.001) {
                           return ((uintptr_t) t1 > (uintptr_t) t2);
                       } else {
-                          return (t1->getFlops() > t2->getFlops());
+                          return (flops1 > flops2);
                       }
                   });
 
@@ -858,6 +1942,115 @@ std::set<ClusteredJob *> StaticClusteringWMS::createHDBJobs(
 }
 
 
+/**
+ * @brief Cluster tasks along partial critical paths, regardless of levels: each cluster starts with the task
+ *        of highest bottom level among those whose parents are all clustered, follows the critical child as
+ *        long as the cluster's estimated makespan fits, and then takes in the tasks that hang off it (and
+ *        then any other task that could start) while it still fits. Since a task only joins a cluster once
+ *        all its parents are in that cluster or earlier ones, the dependencies between clusters are acyclic.
+ * @param num_seconds_per_cluster: the target makespan of each cluster (a cluster has at least one task)
+ * @param num_nodes_per_cluster: the number of hosts used to execute each cluster, 0 to pick it at submission
+ *        time based on queue wait time predictions (clusters are then sized for all the hosts)
+ * @param num_hosts: the number of hosts of the batch service
+ * @param core_speed: the core speed
+ * @param workflow: the workflow
+ * @return the clustered jobs
+ */
+std::set<ClusteredJob *> StaticClusteringWMS::createPCPJobs(
+        unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster, unsigned long num_hosts,
+        double core_speed, Workflow *workflow) {
+
+    std::set<ClusteredJob *> jobs;
+    unsigned long num_nodes = (num_nodes_per_cluster > 0 ? num_nodes_per_cluster : num_hosts);
+
+    // Compute bottom levels
+    std::map<WorkflowTask *, double> bottom_levels;
+    for (long level = (long) workflow->getNumLevels() - 1; level >= 0; level--) {
+        for (auto t : workflow->getTasksInTopLevelRange(level, level)) {
+            double longest_child_path = 0;
+            for (auto child : workflow->getTaskChildren(t)) {
+                longest_child_path = std::max<double>(longest_child_path, bottom_levels[child]);
+            }
+            bottom_levels[t] = WorkflowUtil::getNominalFlops(t) / core_speed + longest_child_path;
+        }
+    }
+
+    // Tasks whose parents are all clustered, highest bottom level first (ties broken by ID)
+    typedef std::tuple<double, std::string, WorkflowTask *> Candidate;
+    auto candidate = [&bottom_levels](WorkflowTask *t) -> Candidate {
+        return std::make_tuple(-bottom_levels[t], t->getID(), t);
+    };
+    std::set<Candidate> eligible_tasks;
+    std::map<WorkflowTask *, unsigned long> num_unclustered_parents;
+    for (auto t : workflow->getTasks()) {
+        num_unclustered_parents[t] = workflow->getTaskParents(t).size();
+        if (num_unclustered_parents[t] == 0) {
+            eligible_tasks.insert(candidate(t));
+        }
+    }
+
+    while (not eligible_tasks.empty()) {
+        std::vector<WorkflowTask *> cluster;
+        // Eligible tasks with a parent in the cluster
+        std::set<Candidate> hanging_tasks;
+
+        auto add_task = [&](WorkflowTask *t) {
+            cluster.push_back(t);
+            eligible_tasks.erase(candidate(t));
+            hanging_tasks.erase(candidate(t));
+            for (auto child : workflow->getTaskChildren(t)) {
+                if (--num_unclustered_parents[child] == 0) {
+                    eligible_tasks.insert(candidate(child));
+                    hanging_tasks.insert(candidate(child));
+                }
+            }
+        };
+        auto fits = [&](WorkflowTask *t) -> bool {
+            std::vector<WorkflowTask *> tasks = cluster;
+            tasks.push_back(t);
+            return WorkflowUtil::estimateMakespan(tasks, num_nodes, core_speed) <= num_seconds_per_cluster;
+        };
+
+        // The partial critical path
+        WorkflowTask *task = std::get<2>(*(eligible_tasks.begin()));
+        add_task(task);
+        while (task != nullptr) {
+            WorkflowTask *critical_child = nullptr;
+            for (auto const &c : hanging_tasks) {
+                auto parents = workflow->getTaskParents(std::get<2>(c));
+                if (std::find(parents.begin(), parents.end(), task) != parents.end()) {
+                    critical_child = std::get<2>(c);
+                    break;
+                }
+            }
+            if ((critical_child != nullptr) and fits(critical_child)) {
+                add_task(critical_child);
+            } else {
+                critical_child = nullptr;
+            }
+            task = critical_child;
+        }
+
+        // The sub-DAG around it, to use the other hosts
+        while (not eligible_tasks.empty()) {
+            task = std::get<2>(hanging_tasks.empty() ? *(eligible_tasks.begin()) : *(hanging_tasks.begin()));
+            if (not fits(task)) {
+                break;
+            }
+            add_task(task);
+        }
+
+        auto job = new ClusteredJob();
+        for (auto t : cluster) {
+            job->addTask(t);
+        }
+        job->setNumNodes(num_nodes_per_cluster);
+        jobs.insert(job);
+    }
+
+    return jobs;
+}
+
 void StaticClusteringWMS::mergeSingleParentSingleChildPairs(Workflow *workflow) {
 // Modify the workflow to cluster tasks
     while (true) {
@@ -882,6 +2075,12 @@ void StaticClusteringWMS::mergeSingleParentSingleChildPairs(Workflow *workflow)
                 parent_to_merge->getID() + "_" + child_to_merge->getID(),
                 parent_to_merge->getFlops() + child_to_merge->getFlops(),
                 1, 1, 1.0);
+        WorkflowUtil::setRuntimeModel(merged_task, WorkflowUtil::getNominalFlops(parent_to_merge) +
+                                                   WorkflowUtil::getNominalFlops(child_to_merge),
+                                      std::max<double>(WorkflowUtil::getRuntimeCV(parent_to_merge),
+                                                       WorkflowUtil::getRuntimeCV(child_to_merge)));
+
+        WorkflowUtil::mergeTaskFiles(merged_task, parent_to_merge, child_to_merge);
 
         for (auto parent : workflow->getTaskParents(parent_to_merge)) {
             workflow->addControlDependency(parent, merged_task);
@@ -913,6 +2112,105 @@ std::set<ClusteredJob *> StaticClusteringWMS::createVCJobs() {
 }
 
 
+/**
+ * @brief Write the clustered jobs to Globals::plan_file, as json, for static:plan-file to load them in later runs
+ * @param jobs: the clustered jobs
+ */
+void StaticClusteringWMS::exportPlan(std::set<ClusteredJob *> jobs) {
+    // Sort the jobs by first task ID, so that the same clustering always gives the same file
+    std::vector<ClusteredJob *> sorted_jobs(jobs.begin(), jobs.end());
+    std::sort(sorted_jobs.begin(), sorted_jobs.end(),
+              [](ClusteredJob *j1, ClusteredJob *j2) -> bool {
+                  return j1->getTasks().at(0)->getID() < j2->getTasks().at(0)->getID();
+              });
+
+    nlohmann::json plan;
+    plan["spec"] = this->algorithm_spec;
+    plan["vertically_clustered"] = this->vertically_clustered;
+    plan["num_tasks"] = this->getWorkflow()->getNumberOfTasks();
+    plan["jobs"] = nlohmann::json::array();
+    for (auto j : sorted_jobs) {
+        nlohmann::json job;
+        job["tasks"] = nlohmann::json::array();
+        for (auto t : j->getTasks()) {
+            job["tasks"].push_back(t->getID());
+        }
+        job["num_nodes"] = j->getNumNodes();
+        job["waste_bound"] = j->getWasteBound();
+        plan["jobs"].push_back(job);
+    }
+
+    std::ofstream out(Globals::plan_file);
+    if (not out) {
+        throw std::runtime_error("Cannot write plan file " + Globals::plan_file);
+    }
+    out << std::setw(4) << plan << std::endl;
+    WRENCH_INFO("Exported a plan of %lu jobs to %s", sorted_jobs.size(), Globals::plan_file.c_str());
+}
+
+/**
+ * @brief Load the clustered jobs of a plan written by exportPlan(), in a run with the same workflow. Numbers
+ *        of nodes that depend on queue wait time predictions are still picked at submission time.
+ * @param plan_file: the plan file
+ * @return the clustered jobs
+ */
+std::set<ClusteredJob *> StaticClusteringWMS::createPlanJobs(std::string plan_file) {
+    std::ifstream file(plan_file);
+    if (not file) {
+        throw std::runtime_error("Cannot read plan file " + plan_file);
+    }
+    nlohmann::json plan;
+    try {
+        file >> plan;
+    } catch (std::exception &e) {
+        throw std::runtime_error("Cannot import plan from file: " + std::string(e.what()));
+    }
+    if (not(plan.count("vertically_clustered") and plan.count("jobs"))) {
+        throw std::runtime_error("Cannot import plan from file: missing vertically_clustered or jobs");
+    }
+
+    // The plan refers to the tasks of the vertically clustered workflow, which is always merged the same way
+    this->vertically_clustered = plan["vertically_clustered"].get<bool>();
+    if (this->vertically_clustered) {
+        mergeSingleParentSingleChildPairs(this->getWorkflow());
+    }
+
+    std::set<WorkflowTask *> clustered_tasks;
+    std::set<ClusteredJob *> jobs;
+    for (auto &plan_job : plan["jobs"]) {
+        ClusteredJob *job = new ClusteredJob();
+        for (auto &id : plan_job["tasks"]) {
+            WorkflowTask *task;
+            try {
+                task = this->getWorkflow()->getTaskByID(id.get<std::string>());
+            } catch (std::invalid_argument &e) {
+                throw std::runtime_error("Plan " + plan_file + " doesn't match the workflow: unknown task " +
+                                         id.get<std::string>());
+            }
+            if (not clustered_tasks.insert(task).second) {
+                throw std::runtime_error("Plan " + plan_file + " doesn't match the workflow: task " +
+                                         task->getID() + " is in several jobs");
+            }
+            job->addTask(task);
+        }
+        if (job->getNumTasks() == 0) {
+            throw std::runtime_error("Plan " + plan_file + " has a job without tasks");
+        }
+        job->setNumNodes(plan_job["num_nodes"].get<unsigned long>());
+        job->setWasteBound(plan_job["waste_bound"].get<double>());
+        jobs.insert(job);
+    }
+    if (clustered_tasks.size() != this->getWorkflow()->getNumberOfTasks()) {
+        throw std::runtime_error("Plan " + plan_file + " doesn't match the workflow: " +
+                                 std::to_string(this->getWorkflow()->getNumberOfTasks() - clustered_tasks.size()) +
+                                 " tasks aren't in any job");
+    }
+
+    WRENCH_INFO("Loaded a plan of %lu jobs from %s", jobs.size(), plan_file.c_str());
+    return jobs;
+}
+
+
 std::set<ClusteredJob *>
 StaticClusteringWMS::applyPosteriorVC(Workflow *workflow, std::set<ClusteredJob *> input_jobs) {
     std::set<ClusteredJob *> output_jobs;
@@ -5,6 +5,8 @@
 #include <wrench-dev.h>
 #include "Simulator.h"
 #include "ClusteredJob.h"
+#include <Util/JobArrays.h>
+#include <Util/PlaceHolderJob.h>
 
 using namespace wrench;
 
@@ -21,6 +23,10 @@ public:
 
     void processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent>) override;
 
+    void processEventPilotJobStart(std::shared_ptr<PilotJobStartedEvent>) override;
+
+    void processEventPilotJobExpiration(std::shared_ptr<PilotJobExpiredEvent>) override;
+
     static std::set<ClusteredJob *>
     createHCJobs(std::string vc, unsigned long num_tasks_per_cluster, unsigned long num_nodes_per_cluster,
                  Workflow *workflow, unsigned long start_level, unsigned long end_level);
@@ -29,6 +35,18 @@ public:
     createDFJSJobs(std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
                    double core_speed, Workflow *workflow, unsigned long start_level, unsigned long end_level);
 
+    static std::set<ClusteredJob *>
+    createDFJSBFDJobs(std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
+                      double core_speed, Workflow *workflow, unsigned long start_level, unsigned long end_level);
+
+    static std::vector<std::vector<WorkflowTask *>>
+    packDFJSClusters(std::vector<WorkflowTask *> tasks, unsigned long num_nodes_per_cluster,
+                     unsigned long num_seconds_per_cluster, double core_speed);
+
+    static std::set<ClusteredJob *>
+    createLocalityJobs(std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
+                       double core_speed, Workflow *workflow, unsigned long start_level, unsigned long end_level);
+
     static std::set<ClusteredJob *>
     createHRBJobs(std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
                   double core_speed, Workflow *workflow, unsigned long start_level, unsigned long end_level);
@@ -41,11 +59,27 @@ public:
     createHDBJobs(std::string vc, unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster,
                   Workflow *workflow, unsigned long start_level, unsigned long end_level);
 
+    static std::set<ClusteredJob *>
+    createPCPJobs(unsigned long num_seconds_per_cluster, unsigned long num_nodes_per_cluster, unsigned long num_hosts,
+                  double core_speed, Workflow *workflow);
+
 private:
-    std::set<ClusteredJob *> createClusteredJobs();
+    std::set<ClusteredJob *> createClusteredJobs(unsigned long start_level = 0);
+
+    unsigned long scaleClusterSize(unsigned long size);
+
+    unsigned long scaleClusterDuration(unsigned long num_seconds, unsigned long start_level, unsigned long end_level);
+
+    double predictWaitTime(unsigned long num_nodes, double requested_time);
+
+    void replan(std::set<ClusteredJob *> &jobs);
 
     std::set<ClusteredJob *> createVCJobs();
 
+    std::set<ClusteredJob *> createPlanJobs(std::string plan_file);
+
+    void exportPlan(std::set<ClusteredJob *> jobs);
+
     static std::set<ClusteredJob *> applyPosteriorVC(Workflow *workflow, std::set<ClusteredJob *>);
 
     static void mergeSingleParentSingleChildPairs(Workflow *workflow);
@@ -54,10 +88,68 @@ private:
 
     static bool isSingleParentSingleChildPair(Workflow *workflow, ClusteredJob *pj, ClusteredJob *cj);
 
-    void submitClusteredJob(ClusteredJob *clustered_job);
+    unsigned long submitClusteredJob(ClusteredJob *clustered_job, unsigned long max_num_batch_jobs = 1);
+
+    std::vector<WorkflowTask *> addStagingTasks(std::vector<WorkflowTask *> tasks);
+
+    unsigned long computeNumNodes(ClusteredJob *clustered_job);
+
+    double getPriority(ClusteredJob *clustered_job);
+
+    std::vector<ClusteredJob *> sortByPriority(std::vector<ClusteredJob *> clustered_jobs);
+
+    void indexPendingJobs(std::set<ClusteredJob *> &jobs);
+
+    void enqueueIfReady(ClusteredJob *clustered_job);
+
+    double getParentsRemainingTime(ClusteredJob *clustered_job);
+
+    void submitLookaheadJobs(std::set<ClusteredJob *> &jobs);
+
+    void dispatchLookaheadTasks(PlaceHolderJob *placeholder_job);
+
+    void terminateLookaheadJob(PlaceHolderJob *placeholder_job);
+
+    static bool isJobArrayElement(ClusteredJob *clustered_job);
+
+    unsigned long getJobArrayElementRequestedMinutes(ClusteredJob *clustered_job);
+
+    void submitJobArray(ClusteredJob *clustered_job, std::set<ClusteredJob *> &jobs);
+
+    JobArrays job_arrays;
+
+    // Predicted queue wait of each submitted job that hasn't completed (with --replan-margin)
+    std::map<wrench::StandardJob *, double> predicted_wait_times;
+
+    // Factor applied to the cluster sizes of the algorithm spec, adjusted when queue waits drift from predictions
+    double cluster_size_factor;
+    bool replan_needed;
+    unsigned long num_replans;
+    double replan_cpu_time;
 
     std::map<wrench::StandardJob *, ClusteredJob *> job_map;
 
+    // Tasks added to stage files in and out of jobs (--staging-bandwidth), and the bytes and time staged
+    std::set<WorkflowTask *> staging_tasks;
+    double staged_bytes;
+    double staging_time;
+
+    // Longest path (in seconds, at nominal flops) from the start of each task to the end of the workflow
+    std::map<WorkflowTask *, double> bottom_levels;
+
+    // Ready jobs that haven't been submitted, as (minus their priority, ID of their first task, job), i.e., in the
+    // order of sortByPriority(), fed as completions make jobs ready (entries of jobs submitted some other way
+    // since, e.g., in a job array, are skipped), and the job that hasn't been submitted of each task
+    std::set<std::tuple<double, std::string, ClusteredJob *>> ready_jobs;
+    std::map<WorkflowTask *, ClusteredJob *> pending_job_of_task;
+
+    // Jobs submitted ahead of their parents' completion as pilot jobs (--static-lookahead), the standard jobs
+    // that run their tasks (with nullptr once the pilot job has expired), and the remaining tasks of expired ones
+    std::set<PlaceHolderJob *> lookahead_placeholder_jobs;
+    std::map<wrench::StandardJob *, PlaceHolderJob *> lookahead_standard_jobs;
+    std::set<ClusteredJob *> expired_jobs;
+    unsigned long num_lookahead_jobs;
+
     Simulator *simulator;
 
     std::shared_ptr<BatchComputeService> batch_service;
@@ -68,6 +160,9 @@ private:
     std::string algorithm_spec;
     double core_speed = 0.0;
 
+    // Whether the jobs are made of the tasks of the vertically clustered workflow (vprior, vc, or a plan of these)
+    bool vertically_clustered = false;
+
     std::shared_ptr<JobManager> job_manager;
 
 
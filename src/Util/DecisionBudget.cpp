@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <set>
+
+#include "DecisionBudget.h"
+
+namespace wrench {
+
+    /**
+     * @brief Constructor
+     * @param budget: the CPU time allotted to each decision, in seconds (0 means no limit), measured with
+     *        std::clock() as the re-planning time is, so that it doesn't depend on the load of the machine
+     */
+    DecisionBudget::DecisionBudget(double budget) {
+        this->budget = budget;
+        this->restart();
+    }
+
+    /**
+     * @brief Start a new decision
+     */
+    void DecisionBudget::restart() {
+        this->start = std::clock();
+        this->truncated = false;
+    }
+
+    /**
+     * @brief Check whether decisions are time-limited
+     * @return true if there is a budget
+     */
+    bool DecisionBudget::isLimited() {
+        return this->budget > 0;
+    }
+
+    /**
+     * @brief Check whether the current decision has used up its budget, in which case the caller
+     *        is expected to skip its remaining candidates (and the decision is marked as truncated)
+     * @return true if the budget is used up
+     */
+    bool DecisionBudget::isExhausted() {
+        if (not this->isLimited()) {
+            return false;
+        }
+        double elapsed = (double) (std::clock() - this->start) / CLOCKS_PER_SEC;
+        if (elapsed >= this->budget) {
+            this->truncated = true;
+        }
+        return this->truncated;
+    }
+
+    /**
+     * @brief Check whether candidates of the current decision were skipped
+     * @return true if the decision was truncated
+     */
+    bool DecisionBudget::wasTruncated() {
+        return this->truncated;
+    }
+
+    /**
+     * @brief Split a range of values in rounds that sample it more and more finely: the first round has
+     *        the two ends of the range, and each following round the midpoints of the previous round's gaps
+     * @param first: the first value
+     * @param last: the last value
+     * @return the rounds, which together contain each value of the range once
+     */
+    std::vector<std::vector<unsigned long>> DecisionBudget::coarseToFine(unsigned long first, unsigned long last) {
+        std::vector<std::vector<unsigned long>> rounds;
+        if (first > last) {
+            return rounds;
+        }
+
+        rounds.push_back({first});
+        if (last > first) {
+            rounds[0].push_back(last);
+        }
+
+        unsigned long stride = 1;
+        while (stride < last - first) {
+            stride *= 2;
+        }
+
+        std::set<unsigned long> seen = {first, last};
+        for (stride /= 2; stride > 0; stride /= 2) {
+            std::vector<unsigned long> round;
+            for (unsigned long v = first + stride; v < last; v += stride) {
+                if (seen.insert(v).second) {
+                    round.push_back(v);
+                }
+            }
+            if (not round.empty()) {
+                rounds.push_back(round);
+            }
+        }
+        return rounds;
+    }
+
+    /**
+     * @brief Order a range of values so that the neighborhood of a hint comes first, followed by
+     *        the rest of the range in coarse-to-fine order
+     * @param first: the first value
+     * @param last: the last value
+     * @param hint: the value that is expected to be best (e.g., the one picked by the previous decision)
+     * @return all the values of the range, in order of promise
+     */
+    std::vector<unsigned long> DecisionBudget::promiseOrder(unsigned long first, unsigned long last,
+                                                            unsigned long hint) {
+        std::vector<unsigned long> order;
+        std::set<unsigned long> seen;
+        if (first > last) {
+            return order;
+        }
+
+        if ((hint >= first) and (hint <= last)) {
+            order.push_back(hint);
+            seen.insert(hint);
+            for (unsigned long d = 1; d <= 2; d++) {
+                if ((hint >= first + d) and seen.insert(hint - d).second) {
+                    order.push_back(hint - d);
+                }
+                if ((hint + d <= last) and seen.insert(hint + d).second) {
+                    order.push_back(hint + d);
+                }
+            }
+        }
+
+        for (auto const &round : coarseToFine(first, last)) {
+            for (auto v : round) {
+                if (seen.insert(v).second) {
+                    order.push_back(v);
+                }
+            }
+        }
+        return order;
+    }
+
+};
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef TASK_CLUSTERING_BATCH_SIMULATOR_DECISIONBUDGET_H
+#define TASK_CLUSTERING_BATCH_SIMULATOR_DECISIONBUDGET_H
+
+#include <ctime>
+#include <vector>
+
+namespace wrench {
+
+    /**
+     * @brief A CPU time budget for one grouping decision, along with helpers to order candidates
+     *        so that the most promising ones are looked at before the budget runs out
+     */
+    class DecisionBudget {
+
+    public:
+
+        explicit DecisionBudget(double budget);
+
+        void restart();
+
+        bool isLimited();
+
+        bool isExhausted();
+
+        bool wasTruncated();
+
+        static std::vector<std::vector<unsigned long>> coarseToFine(unsigned long first, unsigned long last);
+
+        static std::vector<unsigned long> promiseOrder(unsigned long first, unsigned long last, unsigned long hint);
+
+    private:
+
+        double budget;
+        std::clock_t start;
+        bool truncated;
+
+    };
+
+};
+
+
+#endif //TASK_CLUSTERING_BATCH_SIMULATOR_DECISIONBUDGET_H
@@ -0,0 +1,360 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <cfloat>
+#include <algorithm>
+#include <string>
+
+#include "HostScans.h"
+
+// The vectorized kernels are compiled for their instruction set with target attributes, so that the
+// rest of the simulator doesn't need any -m flag and still runs on any x86-64 CPU
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define HOST_SCANS_X86
+#include <immintrin.h>
+#endif
+
+namespace wrench {
+
+    /** Scalar kernels (also used for the elements left over by the vectorized ones) **/
+
+    static double getMinScalar(const double *values, unsigned long num_values) {
+        double min = values[0];
+        for (unsigned long i = 1; i < num_values; i++) {
+            min = std::min<double>(values[i], min);
+        }
+        return min;
+    }
+
+    static double getMinAboveScalar(const double *values, unsigned long num_values, double threshold) {
+        double min = DBL_MAX;
+        for (unsigned long i = 0; i < num_values; i++) {
+            if (values[i] > threshold) {
+                min = std::min<double>(values[i], min);
+            }
+        }
+        return min;
+    }
+
+    static unsigned long findFirstAtMostScalar(const double *values, unsigned long num_values, double threshold) {
+        for (unsigned long i = 0; i < num_values; i++) {
+            if (values[i] <= threshold) {
+                return i;
+            }
+        }
+        return num_values;
+    }
+
+    static double getMaxScalar(const double *values, unsigned long num_values) {
+        double max = values[0];
+        for (unsigned long i = 1; i < num_values; i++) {
+            max = std::max<double>(max, values[i]);
+        }
+        return max;
+    }
+
+#ifdef HOST_SCANS_X86
+
+    /** SSE4.1 kernels (2 doubles at a time) **/
+
+    __attribute__((target("sse4.1")))
+    static double getMinSSE(const double *values, unsigned long num_values) {
+        if (num_values < 2) {
+            return getMinScalar(values, num_values);
+        }
+        __m128d min = _mm_loadu_pd(values);
+        unsigned long i = 2;
+        for (; i + 2 <= num_values; i += 2) {
+            min = _mm_min_pd(min, _mm_loadu_pd(values + i));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, min);
+        double result = std::min<double>(lanes[0], lanes[1]);
+        for (; i < num_values; i++) {
+            result = std::min<double>(values[i], result);
+        }
+        return result;
+    }
+
+    __attribute__((target("sse4.1")))
+    static double getMinAboveSSE(const double *values, unsigned long num_values, double threshold) {
+        __m128d min = _mm_set1_pd(DBL_MAX);
+        __m128d bound = _mm_set1_pd(threshold);
+        unsigned long i = 0;
+        for (; i + 2 <= num_values; i += 2) {
+            __m128d v = _mm_loadu_pd(values + i);
+            min = _mm_min_pd(min, _mm_blendv_pd(_mm_set1_pd(DBL_MAX), v, _mm_cmpgt_pd(v, bound)));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, min);
+        return std::min<double>(std::min<double>(lanes[0], lanes[1]),
+                                getMinAboveScalar(values + i, num_values - i, threshold));
+    }
+
+    __attribute__((target("sse4.1")))
+    static unsigned long findFirstAtMostSSE(const double *values, unsigned long num_values, double threshold) {
+        __m128d bound = _mm_set1_pd(threshold);
+        unsigned long i = 0;
+        for (; i + 2 <= num_values; i += 2) {
+            int mask = _mm_movemask_pd(_mm_cmple_pd(_mm_loadu_pd(values + i), bound));
+            if (mask) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        return i + findFirstAtMostScalar(values + i, num_values - i, threshold);
+    }
+
+    __attribute__((target("sse4.1")))
+    static double getMaxSSE(const double *values, unsigned long num_values) {
+        if (num_values < 2) {
+            return getMaxScalar(values, num_values);
+        }
+        __m128d max = _mm_loadu_pd(values);
+        unsigned long i = 2;
+        for (; i + 2 <= num_values; i += 2) {
+            max = _mm_max_pd(max, _mm_loadu_pd(values + i));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, max);
+        double result = std::max<double>(lanes[0], lanes[1]);
+        for (; i < num_values; i++) {
+            result = std::max<double>(result, values[i]);
+        }
+        return result;
+    }
+
+    /** AVX2 kernels (4 doubles at a time) **/
+
+    __attribute__((target("avx2")))
+    static double getMinAVX2(const double *values, unsigned long num_values) {
+        if (num_values < 4) {
+            return getMinScalar(values, num_values);
+        }
+        __m256d min = _mm256_loadu_pd(values);
+        unsigned long i = 4;
+        for (; i + 4 <= num_values; i += 4) {
+            min = _mm256_min_pd(min, _mm256_loadu_pd(values + i));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, min);
+        double result = getMinScalar(lanes, 4);
+        for (; i < num_values; i++) {
+            result = std::min<double>(values[i], result);
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2")))
+    static double getMinAboveAVX2(const double *values, unsigned long num_values, double threshold) {
+        __m256d min = _mm256_set1_pd(DBL_MAX);
+        __m256d bound = _mm256_set1_pd(threshold);
+        unsigned long i = 0;
+        for (; i + 4 <= num_values; i += 4) {
+            __m256d v = _mm256_loadu_pd(values + i);
+            min = _mm256_min_pd(min, _mm256_blendv_pd(_mm256_set1_pd(DBL_MAX), v,
+                                                      _mm256_cmp_pd(v, bound, _CMP_GT_OQ)));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, min);
+        return std::min<double>(getMinScalar(lanes, 4), getMinAboveScalar(values + i, num_values - i, threshold));
+    }
+
+    __attribute__((target("avx2")))
+    static unsigned long findFirstAtMostAVX2(const double *values, unsigned long num_values, double threshold) {
+        __m256d bound = _mm256_set1_pd(threshold);
+        unsigned long i = 0;
+        for (; i + 4 <= num_values; i += 4) {
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(values + i), bound, _CMP_LE_OQ));
+            if (mask) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        return i + findFirstAtMostScalar(values + i, num_values - i, threshold);
+    }
+
+    __attribute__((target("avx2")))
+    static double getMaxAVX2(const double *values, unsigned long num_values) {
+        if (num_values < 4) {
+            return getMaxScalar(values, num_values);
+        }
+        __m256d max = _mm256_loadu_pd(values);
+        unsigned long i = 4;
+        for (; i + 4 <= num_values; i += 4) {
+            max = _mm256_max_pd(max, _mm256_loadu_pd(values + i));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, max);
+        double result = getMaxScalar(lanes, 4);
+        for (; i < num_values; i++) {
+            result = std::max<double>(result, values[i]);
+        }
+        return result;
+    }
+
+    /** AVX-512 kernels (8 doubles at a time) **/
+
+    __attribute__((target("avx512f")))
+    static double getMinAVX512(const double *values, unsigned long num_values) {
+        if (num_values < 8) {
+            return getMinScalar(values, num_values);
+        }
+        __m512d min = _mm512_loadu_pd(values);
+        unsigned long i = 8;
+        for (; i + 8 <= num_values; i += 8) {
+            // (the masked form, since GCC warns about the undefined source operand of _mm512_min_pd)
+            min = _mm512_mask_min_pd(min, 0xFF, min, _mm512_loadu_pd(values + i));
+        }
+        double lanes[8];
+        _mm512_storeu_pd(lanes, min);
+        double result = getMinScalar(lanes, 8);
+        for (; i < num_values; i++) {
+            result = std::min<double>(values[i], result);
+        }
+        return result;
+    }
+
+    __attribute__((target("avx512f")))
+    static double getMinAboveAVX512(const double *values, unsigned long num_values, double threshold) {
+        __m512d min = _mm512_set1_pd(DBL_MAX);
+        __m512d bound = _mm512_set1_pd(threshold);
+        unsigned long i = 0;
+        for (; i + 8 <= num_values; i += 8) {
+            __m512d v = _mm512_loadu_pd(values + i);
+            min = _mm512_mask_min_pd(min, _mm512_cmp_pd_mask(v, bound, _CMP_GT_OQ), min, v);
+        }
+        double lanes[8];
+        _mm512_storeu_pd(lanes, min);
+        return std::min<double>(getMinScalar(lanes, 8), getMinAboveScalar(values + i, num_values - i, threshold));
+    }
+
+    __attribute__((target("avx512f")))
+    static unsigned long findFirstAtMostAVX512(const double *values, unsigned long num_values, double threshold) {
+        __m512d bound = _mm512_set1_pd(threshold);
+        unsigned long i = 0;
+        for (; i + 8 <= num_values; i += 8) {
+            __mmask8 mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(values + i), bound, _CMP_LE_OQ);
+            if (mask) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+        return i + findFirstAtMostScalar(values + i, num_values - i, threshold);
+    }
+
+    __attribute__((target("avx512f")))
+    static double getMaxAVX512(const double *values, unsigned long num_values) {
+        if (num_values < 8) {
+            return getMaxScalar(values, num_values);
+        }
+        __m512d max = _mm512_loadu_pd(values);
+        unsigned long i = 8;
+        for (; i + 8 <= num_values; i += 8) {
+            max = _mm512_mask_max_pd(max, 0xFF, max, _mm512_loadu_pd(values + i));
+        }
+        double lanes[8];
+        _mm512_storeu_pd(lanes, max);
+        double result = getMaxScalar(lanes, 8);
+        for (; i < num_values; i++) {
+            result = std::max<double>(result, values[i]);
+        }
+        return result;
+    }
+
+#endif
+
+    /**
+     * @brief Get the kernels of an instruction set (e.g., to compare them with the scalar ones)
+     * @param instruction_set: "avx512", "avx2", "sse4.1", or "scalar"
+     * @param kernels: the kernels (set if the instruction set is available)
+     * @return false if the kernels aren't compiled in or the CPU doesn't support the instruction set
+     */
+    bool HostScans::getKernels(const std::string &instruction_set, HostScans::Kernels &kernels) {
+        if (instruction_set == "scalar") {
+            kernels = {getMinScalar, getMinAboveScalar, findFirstAtMostScalar, getMaxScalar};
+            return true;
+        }
+#ifdef HOST_SCANS_X86
+        __builtin_cpu_init();
+        if ((instruction_set == "avx512") and __builtin_cpu_supports("avx512f")) {
+            kernels = {getMinAVX512, getMinAboveAVX512, findFirstAtMostAVX512, getMaxAVX512};
+            return true;
+        }
+        if ((instruction_set == "avx2") and __builtin_cpu_supports("avx2")) {
+            kernels = {getMinAVX2, getMinAboveAVX2, findFirstAtMostAVX2, getMaxAVX2};
+            return true;
+        }
+        if ((instruction_set == "sse4.1") and __builtin_cpu_supports("sse4.1")) {
+            kernels = {getMinSSE, getMinAboveSSE, findFirstAtMostSSE, getMaxSSE};
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    /**
+     * @brief Get the kernels of the widest instruction set that the CPU supports, picked on the first call
+     *        (thread-safely, since makespan estimates may run in several threads)
+     * @return the kernels
+     */
+    static const HostScans::Kernels &getWidestKernels() {
+        static const HostScans::Kernels kernels = []() -> HostScans::Kernels {
+            HostScans::Kernels widest_kernels;
+            for (auto instruction_set : {"avx512", "avx2", "sse4.1"}) {
+                if (HostScans::getKernels(instruction_set, widest_kernels)) {
+                    return widest_kernels;
+                }
+            }
+            HostScans::getKernels("scalar", widest_kernels);
+            return widest_kernels;
+        }();
+        return kernels;
+    }
+
+    /**
+     * @brief Get the smallest value
+     * @param values: the values
+     * @param num_values: the number of values (at least 1)
+     * @return the smallest value
+     */
+    double HostScans::getMin(const double *values, unsigned long num_values) {
+        return getWidestKernels().get_min(values, num_values);
+    }
+
+    /**
+     * @brief Get the smallest value above a threshold (e.g., the next date at which a host becomes idle)
+     * @param values: the values
+     * @param num_values: the number of values
+     * @param threshold: the threshold
+     * @return the smallest value strictly greater than the threshold, DBL_MAX if none
+     */
+    double HostScans::getMinAbove(const double *values, unsigned long num_values, double threshold) {
+        return getWidestKernels().get_min_above(values, num_values, threshold);
+    }
+
+    /**
+     * @brief Find the first value at most equal to a threshold (e.g., the first host idle at some date)
+     * @param values: the values
+     * @param num_values: the number of values
+     * @param threshold: the threshold
+     * @return the index of the value, num_values if none
+     */
+    unsigned long HostScans::findFirstAtMost(const double *values, unsigned long num_values, double threshold) {
+        return getWidestKernels().find_first_at_most(values, num_values, threshold);
+    }
+
+    /**
+     * @brief Get the largest value
+     * @param values: the values
+     * @param num_values: the number of values (at least 1)
+     * @return the largest value
+     */
+    double HostScans::getMax(const double *values, unsigned long num_values) {
+        return getWidestKernels().get_max(values, num_values);
+    }
+
+}
@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef TASK_CLUSTERING_BATCH_SIMULATOR_HOSTSCANS_H
+#define TASK_CLUSTERING_BATCH_SIMULATOR_HOSTSCANS_H
+
+#include <string>
+
+namespace wrench {
+
+    /**
+     * @brief Scans of the host idle dates of makespan estimates, vectorized with the widest instruction set
+     *        that the CPU supports (AVX-512, AVX2, SSE4.1, or none), which is picked at run time. They give
+     *        exactly the same results as the scalar loops.
+     */
+    class HostScans {
+
+    public:
+
+        // The kernels of one instruction set
+        struct Kernels {
+            double (*get_min)(const double *, unsigned long);
+            double (*get_min_above)(const double *, unsigned long, double);
+            unsigned long (*find_first_at_most)(const double *, unsigned long, double);
+            double (*get_max)(const double *, unsigned long);
+        };
+
+        static double getMin(const double *values, unsigned long num_values);
+
+        static double getMinAbove(const double *values, unsigned long num_values, double threshold);
+
+        static unsigned long findFirstAtMost(const double *values, unsigned long num_values, double threshold);
+
+        static double getMax(const double *values, unsigned long num_values);
+
+        static bool getKernels(const std::string &instruction_set, Kernels &kernels);
+
+    };
+
+};
+
+
+#endif //TASK_CLUSTERING_BATCH_SIMULATOR_HOSTSCANS_H
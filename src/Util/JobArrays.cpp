@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "JobArrays.h"
+#include "Globals.h"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(job_arrays, "Log category for Job Arrays");
+
+namespace wrench {
+
+    /**
+     * @brief Check whether single-task jobs are submitted as job arrays
+     * @return true if arrays can have more than one element
+     */
+    bool JobArrays::isEnabled() {
+        return Globals::max_job_array_size > 1;
+    }
+
+    /**
+     * @brief Submit a job array, with one single-node job per task
+     * @param job_manager: the job manager
+     * @param batch_service: the batch service
+     * @param tasks: the tasks (all ready)
+     * @param requested_minutes: the requested time of each element, in minutes
+     * @return the number of jobs submitted
+     */
+    unsigned long JobArrays::submit(std::shared_ptr<JobManager> job_manager,
+                                    std::shared_ptr<BatchComputeService> batch_service,
+                                    std::vector<WorkflowTask *> tasks, unsigned long requested_minutes) {
+        if (tasks.empty()) {
+            return 0;
+        }
+
+        unsigned long array_id = this->next_array_id++;
+        this->num_remaining_elements[array_id] = tasks.size();
+
+        for (auto task : tasks) {
+            auto standard_job = job_manager->createStandardJob(task, {});
+            std::map<std::string, std::string> service_specific_args;
+            service_specific_args["-N"] = "1";
+            service_specific_args["-c"] = "1";
+            service_specific_args["-t"] = std::to_string(requested_minutes);
+
+            this->element_arrays[standard_job.get()] = array_id;
+            job_manager->submitJob(standard_job, batch_service, service_specific_args);
+        }
+
+        WRENCH_INFO("Submitted a job array of %lu tasks (%lu min)", tasks.size(), requested_minutes);
+
+        Globals::num_job_arrays++;
+        Globals::num_job_array_elements += tasks.size();
+
+        return tasks.size();
+    }
+
+    /**
+     * @brief Record that a job is done (completed or failed)
+     * @param job: the job
+     * @return true if the job was the last element of its array that wasn't done, or isn't part of an array,
+     *         i.e., if one fewer job is in the system
+     */
+    bool JobArrays::completeElement(StandardJob *job) {
+        auto element = this->element_arrays.find(job);
+        if (element == this->element_arrays.end()) {
+            return true;
+        }
+
+        unsigned long array_id = element->second;
+        this->element_arrays.erase(element);
+        if (--this->num_remaining_elements[array_id] > 0) {
+            return false;
+        }
+        this->num_remaining_elements.erase(array_id);
+        return true;
+    }
+
+};
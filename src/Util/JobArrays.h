@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef TASK_CLUSTERING_BATCH_SIMULATOR_JOBARRAYS_H
+#define TASK_CLUSTERING_BATCH_SIMULATOR_JOBARRAYS_H
+
+#include <wrench-dev.h>
+
+namespace wrench {
+
+    /**
+     * @brief Job arrays of single-node, single-task jobs with the same requested time, as with Slurm/PBS arrays.
+     *        The batch service schedules each element as a job of its own, but an array counts as one job against
+     *        the maximum number of jobs in the system until all its elements are done.
+     */
+    class JobArrays {
+
+    public:
+
+        static bool isEnabled();
+
+        unsigned long submit(std::shared_ptr<JobManager> job_manager, std::shared_ptr<BatchComputeService> batch_service,
+                             std::vector<WorkflowTask *> tasks, unsigned long requested_minutes);
+
+        bool completeElement(StandardJob *job);
+
+    private:
+
+        // Array of each element that isn't done, and number of elements of each array that aren't done
+        std::map<StandardJob *, unsigned long> element_arrays;
+        std::map<unsigned long, unsigned long> num_remaining_elements;
+
+        unsigned long next_array_id = 0;
+
+    };
+
+};
+
+
+#endif //TASK_CLUSTERING_BATCH_SIMULATOR_JOBARRAYS_H
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+
+#include "ParetoFront.h"
+#include "Globals.h"
+
+namespace wrench {
+
+    /**
+     * @brief Check whether fronts are needed, either to be exported or to pick numbers of nodes. If so,
+     *        searches must look at all candidates, as pruned ones may be on the front.
+     * @return true if fronts are needed
+     */
+    bool ParetoFront::isEnabled() {
+        return Globals::export_pareto_fronts or isUsedForChoice();
+    }
+
+    /**
+     * @brief Check whether numbers of nodes are picked from the front rather than by finish time only
+     * @return true if a weight was given
+     */
+    bool ParetoFront::isUsedForChoice() {
+        return Globals::pareto_weight >= 0;
+    }
+
+    /**
+     * @brief Forget all candidates
+     */
+    void ParetoFront::clear() {
+        this->candidates.clear();
+    }
+
+    /**
+     * @brief Add a candidate
+     * @param num_nodes: the number of nodes
+     * @param finish_time: the predicted finish time
+     * @param node_seconds: the requested node-seconds
+     */
+    void ParetoFront::add(unsigned long num_nodes, double finish_time, double node_seconds) {
+        this->candidates.push_back(std::make_tuple(num_nodes, finish_time, node_seconds));
+    }
+
+    /**
+     * @brief Get the candidates that no other candidate beats on both finish time and node-seconds
+     * @return the non-dominated candidates, by increasing finish time
+     */
+    std::vector<std::tuple<unsigned long, double, double>> ParetoFront::getFront() {
+        std::vector<std::tuple<unsigned long, double, double>> sorted = this->candidates;
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const std::tuple<unsigned long, double, double> &c1,
+                            const std::tuple<unsigned long, double, double> &c2) -> bool {
+                             if (std::get<1>(c1) == std::get<1>(c2)) {
+                                 return std::get<2>(c1) < std::get<2>(c2);
+                             }
+                             return std::get<1>(c1) < std::get<1>(c2);
+                         });
+
+        std::vector<std::tuple<unsigned long, double, double>> front;
+        double min_node_seconds = DBL_MAX;
+        for (auto const &candidate : sorted) {
+            if (std::get<2>(candidate) < min_node_seconds) {
+                front.push_back(candidate);
+                min_node_seconds = std::get<2>(candidate);
+            }
+        }
+        return front;
+    }
+
+    /**
+     * @brief Pick a point of the front, minimizing weight * finish time + (1 - weight) * node-seconds,
+     *        each normalized by its smallest value on the front
+     * @param weight: the weight of the finish time, in [0,1]
+     * @return the number of nodes of the point (ULONG_MAX if there is no candidate)
+     */
+    unsigned long ParetoFront::pick(double weight) {
+        std::vector<std::tuple<unsigned long, double, double>> front = getFront();
+        if (front.empty()) {
+            return ULONG_MAX;
+        }
+
+        // The front is sorted by increasing finish time and decreasing node-seconds
+        double min_finish_time = std::max<double>(std::get<1>(front.front()), DBL_MIN);
+        double min_node_seconds = std::max<double>(std::get<2>(front.back()), DBL_MIN);
+
+        unsigned long best_num_nodes = ULONG_MAX;
+        double best_score = DBL_MAX;
+        for (auto const &point : front) {
+            double score = weight * std::get<1>(point) / min_finish_time +
+                           (1 - weight) * std::get<2>(point) / min_node_seconds;
+            if (score < best_score) {
+                best_score = score;
+                best_num_nodes = std::get<0>(point);
+            }
+        }
+        return best_num_nodes;
+    }
+
+    /**
+     * @brief Get the front in a form that can be added to the simulation output
+     * @return a list of {num_nodes, finish_time, node_seconds} objects
+     */
+    nlohmann::json ParetoFront::toJSON() {
+        nlohmann::json json = nlohmann::json::array();
+        for (auto const &point : getFront()) {
+            nlohmann::json json_point;
+            json_point["num_nodes"] = std::get<0>(point);
+            json_point["finish_time"] = std::get<1>(point);
+            json_point["node_seconds"] = std::get<2>(point);
+            json.push_back(json_point);
+        }
+        return json;
+    }
+
+};
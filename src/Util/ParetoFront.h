@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef TASK_CLUSTERING_BATCH_SIMULATOR_PARETOFRONT_H
+#define TASK_CLUSTERING_BATCH_SIMULATOR_PARETOFRONT_H
+
+#include <tuple>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace wrench {
+
+    /**
+     * @brief The (predicted finish time, requested node-seconds) candidates looked at by one
+     *        number-of-nodes decision, and those of them that are not dominated
+     */
+    class ParetoFront {
+
+    public:
+
+        static bool isEnabled();
+
+        static bool isUsedForChoice();
+
+        void clear();
+
+        void add(unsigned long num_nodes, double finish_time, double node_seconds);
+
+        std::vector<std::tuple<unsigned long, double, double>> getFront();
+
+        unsigned long pick(double weight);
+
+        nlohmann::json toJSON();
+
+    private:
+
+        // (num nodes, finish time, node-seconds)
+        std::vector<std::tuple<unsigned long, double, double>> candidates;
+
+    };
+
+};
+
+
+#endif //TASK_CLUSTERING_BATCH_SIMULATOR_PARETOFRONT_H
@@ -4,6 +4,8 @@
 
 #include <Util/PlaceHolderJob.h>
 #include <workflow/job/PilotJob.h>
+#include <StaticClusteringAlgorithms/ClusteredJob.h>
+#include <Util/WorkflowUtil.h>
 #include <map>
 #include <string>
 
@@ -16,10 +18,12 @@ namespace wrench {
         std::sort(tasks.begin(), tasks.end(),
                   [](const WorkflowTask *t1, const WorkflowTask *t2) -> bool {
 
-                      if (t1->getFlops() == t2->getFlops()) {
+                      double flops1 = WorkflowUtil::getNominalFlops(t1);
+                      double flops2 = WorkflowUtil::getNominalFlops(t2);
+                      if (flops1 == flops2) {
                           return (t1->getID() > t2->getID());
                       }
-                      return (t1->getFlops() > t2->getFlops());
+                      return (flops1 > flops2);
                   });
 
         this->pilot_job = pilot_job;
@@ -27,6 +31,10 @@ namespace wrench {
         this->tasks = tasks;
         this->start_level = start_level;
         this->end_level = end_level;
+        this->clustered_job = nullptr;
+
+        this->indexTasks();
+        this->initializeReadyTasks();
     }
 
     PlaceHolderJob::PlaceHolderJob(std::shared_ptr<PilotJob> pilot_job, ClusteredJob *clustered_job, unsigned long start_level,
@@ -34,8 +42,21 @@ namespace wrench {
         this->pilot_job = pilot_job;
         this->num_hosts = ULONG_MAX;
         this->clustered_job = clustered_job;
+        this->tasks = clustered_job->getTasks();
         this->start_level = start_level;
         this->end_level = end_level;
+
+        this->indexTasks();
+        this->initializeReadyTasks();
+    }
+
+    void PlaceHolderJob::indexTasks() {
+        this->task_indices.clear();
+        for (unsigned long i = 0; i < this->tasks.size(); i++) {
+            this->task_indices[this->tasks[i]] = i;
+        }
+        this->completed_tasks = std::vector<bool>(this->tasks.size(), false);
+        this->num_completed_tasks = 0;
     }
 
     // Requested time of job
@@ -45,6 +66,196 @@ namespace wrench {
         // Duration stored in minutes, convert back to seconds
         return (duration - 1) * 60;
     }
-}
 
+    bool PlaceHolderJob::hasTask(WorkflowTask *task) {
+        return this->task_indices.find(task) != this->task_indices.end();
+    }
+
+    /**
+     * @brief Scan the tasks to seed the ready queue (when the placeholder job is created, so that other
+     *        placeholder jobs can take its ready tasks, and when its pilot job starts), after which the
+     *        WMS only has to enqueue tasks as their last parent completes
+     */
+    void PlaceHolderJob::initializeReadyTasks() {
+        this->ready_tasks.clear();
+        for (auto task : this->tasks) {
+            if (task->getState() == WorkflowTask::COMPLETED) {
+                this->markTaskCompleted(task);
+            } else if (task->getState() == WorkflowTask::READY) {
+                this->enqueueReadyTask(task);
+            }
+        }
+    }
+
+    void PlaceHolderJob::enqueueReadyTask(WorkflowTask *task) {
+        auto it = this->task_indices.find(task);
+        if (it == this->task_indices.end()) {
+            throw std::runtime_error("PlaceHolderJob::enqueueReadyTask(): task " + task->getID() +
+                                     " is not part of this placeholder job");
+        }
+        // a set, so that a task made ready by several completions is only queued once
+        this->ready_tasks.insert(std::make_pair(task->getTopLevel(), it->second));
+    }
+
+    /**
+     * @brief Pop the next ready task, lower levels first and then in task order
+     * @return a task, or nullptr if the queue is empty
+     */
+    WorkflowTask *PlaceHolderJob::popReadyTask() {
+        this->enqueueReturnedTasks();
+        if (this->ready_tasks.empty()) {
+            return nullptr;
+        }
+        auto first = this->ready_tasks.begin();
+        WorkflowTask *task = this->tasks[first->second];
+        this->ready_tasks.erase(first);
+        return task;
+    }
+
+    /**
+     * @brief Queue the tasks given back by other placeholder jobs that have become ready since
+     */
+    void PlaceHolderJob::enqueueReturnedTasks() {
+        for (auto it = this->returned_tasks.begin(); it != this->returned_tasks.end();) {
+            WorkflowTask *task = *it;
+            if (task->getState() == WorkflowTask::READY) {
+                this->enqueueReadyTask(task);
+            } else if (task->getState() != WorkflowTask::COMPLETED) {
+                ++it;
+                continue;
+            }
+            it = this->returned_tasks.erase(it);
+        }
+    }
+
+    void PlaceHolderJob::markTaskCompleted(WorkflowTask *task) {
+        auto it = this->task_indices.find(task);
+        if ((it == this->task_indices.end()) or (this->completed_tasks[it->second])) {
+            return;
+        }
+        this->completed_tasks[it->second] = true;
+        this->num_completed_tasks++;
+    }
 
+    bool PlaceHolderJob::areAllTasksCompleted() {
+        return this->num_completed_tasks == this->tasks.size();
+    }
+
+    /**
+     * @brief Get the number of tasks that can run at once in the pilot job
+     * @return the number of hosts
+     */
+    unsigned long PlaceHolderJob::getNumSlots() {
+        if (this->clustered_job != nullptr) {
+            return this->clustered_job->getNumNodes();
+        }
+        return this->num_hosts;
+    }
+
+    /**
+     * @brief Take a ready task of another placeholder job whose estimated runtime fits in the remaining
+     *        time of this (running) one, to run it on an idle host of this one. The victim's ready queue
+     *        is walked in priority order, and the entries of tasks that are no longer ready are dropped
+     * @param victim: the placeholder job to take the task from
+     * @param date: the current date
+     * @param core_speed: the core speed
+     * @return a task (to be submitted to this placeholder job's pilot job), or nullptr if none fits
+     */
+    WorkflowTask *PlaceHolderJob::stealReadyTask(PlaceHolderJob *victim, double date, double core_speed) {
+        double remaining_time = this->start_date + this->getDuration() - date;
+        victim->enqueueReturnedTasks();
+        for (auto it = victim->ready_tasks.begin(); it != victim->ready_tasks.end();) {
+            WorkflowTask *task = victim->tasks[it->second];
+            // may have been submitted some other way since it was queued (e.g., individually)
+            if ((task->getState() != WorkflowTask::READY) or
+                (victim->lent_tasks.find(task) != victim->lent_tasks.end())) {
+                it = victim->ready_tasks.erase(it);
+                continue;
+            }
+            if (WorkflowUtil::getNominalFlops(task) / core_speed <= remaining_time) {
+                victim->ready_tasks.erase(it);
+                victim->lent_tasks.insert(task);
+                this->stolen_tasks[task] = victim;
+                return task;
+            }
+            ++it;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Give a stolen task that didn't complete (e.g., because the pilot job expired) back to
+     *        the placeholder job it belongs to, and put it back in that placeholder job's ready queue:
+     *        right away if it is ready, or as soon as it is if its state is still that of the killed
+     *        standard job (a task that isn't ready is queued by the WMS when its last parent completes)
+     * @param task: the task
+     * @return the placeholder job the task belongs to (nullptr if the task wasn't stolen)
+     */
+    PlaceHolderJob *PlaceHolderJob::returnStolenTask(WorkflowTask *task) {
+        auto it = this->stolen_tasks.find(task);
+        if (it == this->stolen_tasks.end()) {
+            return nullptr;
+        }
+        PlaceHolderJob *owner = it->second;
+        owner->lent_tasks.erase(task);
+        this->stolen_tasks.erase(it);
+
+        if (task->getState() == WorkflowTask::READY) {
+            owner->enqueueReadyTask(task);
+        } else if ((task->getState() != WorkflowTask::COMPLETED) and
+                   (task->getState() != WorkflowTask::NOT_READY)) {
+            owner->returned_tasks.insert(task);
+        }
+        return owner;
+    }
+
+    /**
+     * @brief Get the tasks that run (or ran) in the pilot job: its own tasks, except those that another
+     *        placeholder job took, and the tasks it took from other placeholder jobs
+     * @return a list of tasks
+     */
+    std::vector<WorkflowTask *> PlaceHolderJob::getExecutedTasks() {
+        if (this->stolen_tasks.empty() and this->lent_tasks.empty()) {
+            return this->tasks;
+        }
+        std::vector<WorkflowTask *> executed_tasks;
+        for (auto task : this->tasks) {
+            if (this->lent_tasks.find(task) == this->lent_tasks.end()) {
+                executed_tasks.push_back(task);
+            }
+        }
+        for (auto const &stolen_task : this->stolen_tasks) {
+            executed_tasks.push_back(stolen_task.first);
+        }
+        return executed_tasks;
+    }
+
+    /**
+     * @brief Check whether some of the tasks that this placeholder job is in charge of haven't completed
+     * @return true if a task (not run by another placeholder job) isn't completed
+     */
+    bool PlaceHolderJob::hasUnprocessedTasks() {
+        for (auto task : this->getExecutedTasks()) {
+            if (task->getState() != WorkflowTask::COMPLETED) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Check whether the pilot job can be terminated
+     * @return true if all its tasks, and all the tasks it took from other placeholder jobs, are completed
+     */
+    bool PlaceHolderJob::isDone() {
+        if (not this->areAllTasksCompleted()) {
+            return false;
+        }
+        for (auto const &stolen_task : this->stolen_tasks) {
+            if (stolen_task.first->getState() != WorkflowTask::COMPLETED) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -4,6 +4,9 @@
 #define YOUR_PROJECT_NAME_PLACEHOLDERJOB_H
 
 #include <vector>
+#include <set>
+#include <map>
+#include <unordered_map>
 #include <wrench-dev.h>
 
 namespace wrench {
@@ -40,8 +43,62 @@ namespace wrench {
 
         double getDuration();
 
+        bool hasTask(WorkflowTask *task);
+
+        // Ready queue, seeded when the placeholder job is created (and again when its pilot job starts)
+        // and then fed by the WMS on task completions
+        void initializeReadyTasks();
+
+        void enqueueReadyTask(WorkflowTask *task);
+
+        WorkflowTask *popReadyTask();
+
+        void markTaskCompleted(WorkflowTask *task);
+
+        bool areAllTasksCompleted();
+
+        // Work stealing (--work-stealing): tasks of other placeholder jobs run on idle hosts of this one
+        unsigned long getNumSlots();
+
+        WorkflowTask *stealReadyTask(PlaceHolderJob *victim, double date, double core_speed);
+
+        PlaceHolderJob *returnStolenTask(WorkflowTask *task);
+
+        std::vector<WorkflowTask *> getExecutedTasks();
+
+        bool hasUnprocessedTasks();
+
+        bool isDone();
+
+        // Date at which the pilot job started (-1 if it hasn't)
+        double start_date = -1;
+
+        // Tasks of other placeholder jobs that this one runs, with the placeholder job they belong to
+        std::map<WorkflowTask *, PlaceHolderJob *> stolen_tasks;
+
+        // Tasks of this placeholder job that another one runs
+        std::set<WorkflowTask *> lent_tasks;
+
+        // Tasks given back by another placeholder job before their state was reset, queued once they are ready
+        std::set<WorkflowTask *> returned_tasks;
+
         // For lbl
         ClusteredJob *clustered_job;
+
+    private:
+
+        void indexTasks();
+
+        void enqueueReturnedTasks();
+
+        // position of each task in this->tasks
+        std::unordered_map<WorkflowTask *, unsigned long> task_indices;
+
+        // (top level, position in this->tasks) of the ready tasks that haven't been dispatched
+        std::set<std::pair<unsigned long, unsigned long>> ready_tasks;
+
+        std::vector<bool> completed_tasks;
+        unsigned long num_completed_tasks = 0;
     };
 
 };
@@ -7,6 +7,8 @@
 #include <services/compute/batch/BatchComputeService.h>
 #include "ProxyWMS.h"
 #include "PlaceHolderJob.h"
+#include "WorkflowUtil.h"
+#include "Globals.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(proxy_wms, "Log category for Proxy WMS");
 
@@ -25,8 +27,6 @@ namespace wrench {
                                                             unsigned long start_level,
                                                             unsigned long end_level) {
 
-        requested_execution_time = requested_execution_time * EXECUTION_TIME_FUDGE_FACTOR;
-
         // Aggregate tasks
         std::vector<WorkflowTask *> tasks;
         for (unsigned long l = start_level; l <= end_level; l++) {
@@ -38,6 +38,10 @@ namespace wrench {
             }
         }
 
+        // The factor is a ratio of makespans, and so doesn't depend on the core speed
+        requested_execution_time = requested_execution_time *
+                                   WorkflowUtil::getWalltimeFactor(tasks, requested_parallelism, 1.0);
+
         // Submit the pilot job
         std::map<std::string, std::string> service_specific_args;
         service_specific_args["-N"] = std::to_string(requested_parallelism);
@@ -59,27 +63,186 @@ namespace wrench {
         return pj;
     }
 
+    /**
+     * @brief Submit ready tasks as one-host jobs, as long as the number of jobs in the system allows it
+     *        (the ready set is built with one scan of the workflow on the first call, and afterwards
+     *        only fed by enqueueReadyChildren())
+     * @param core_speed: the core speed
+     * @param num_jobs_in_system: the number of jobs in the system (updated)
+     * @param max_num_jobs: the maximum number of jobs in the system
+     */
     void ProxyWMS::submitAllOneJobPerTask(double core_speed, unsigned long * num_jobs_in_system, unsigned long max_num_jobs) {
-        for (auto task : this->workflow->getTasks()) {
-            if (task->getState() == WorkflowTask::State::READY and (*num_jobs_in_system < max_num_jobs)) {
-                // std::cout << "Submitting as ojpt, num jobs in system before submission: " << (*num_jobs_in_system) << std::endl;
-                auto standard_job = this->job_manager->createStandardJob(task, {});
-                std::map<std::string, std::string> service_specific_args;
-                // TODO - this cast is horrible, but should be okay?
-                unsigned long requested_execution_time =
-                        (unsigned long) (task->getFlops() / core_speed) * EXECUTION_TIME_FUDGE_FACTOR;
-                service_specific_args["-N"] = "1";
-                service_specific_args["-c"] = "1";
-                service_specific_args["-t"] = std::to_string(1 + ((unsigned long) requested_execution_time) / 60);
-
-                WRENCH_INFO("Submitting task %s individually!", task->getID().c_str());
-                // std::cout << "Submitting task " << task->getID().c_str() << " individually!\n";
-                this->job_manager->submitJob(standard_job, this->batch_service, service_specific_args);
-                (*num_jobs_in_system)++;
+        if (not this->ready_tasks_initialized) {
+            for (auto task : this->workflow->getTasks()) {
+                if (task->getState() == WorkflowTask::State::READY) {
+                    this->ready_tasks.insert(task);
+                }
+            }
+            this->ready_tasks_initialized = true;
+        }
+
+        if (JobArrays::isEnabled()) {
+            this->submitJobArrays(core_speed, num_jobs_in_system, max_num_jobs);
+            return;
+        }
+
+        while ((not this->ready_tasks.empty()) and (*num_jobs_in_system < max_num_jobs)) {
+            WorkflowTask *task = *(this->ready_tasks.begin());
+            this->ready_tasks.erase(this->ready_tasks.begin());
+            // may have been submitted as part of a placeholder job since it was queued
+            if (task->getState() != WorkflowTask::State::READY) {
+                continue;
+            }
+
+            // std::cout << "Submitting as ojpt, num jobs in system before submission: " << (*num_jobs_in_system) << std::endl;
+            // TODO - this cast is horrible, but should be okay?
+            unsigned long requested_execution_time =
+                    (unsigned long) (WorkflowUtil::getNominalFlops(task) / core_speed) *
+                    WorkflowUtil::getWalltimeFactor({task}, 1, core_speed);
+
+            auto standard_job = this->job_manager->createStandardJob(task, {});
+            std::map<std::string, std::string> service_specific_args;
+            service_specific_args["-N"] = "1";
+            service_specific_args["-c"] = "1";
+            service_specific_args["-t"] = std::to_string(1 + ((unsigned long) requested_execution_time) / 60);
+
+            WRENCH_INFO("Submitting task %s individually!", task->getID().c_str());
+            // std::cout << "Submitting task " << task->getID().c_str() << " individually!\n";
+            this->job_manager->submitJob(standard_job, this->batch_service, service_specific_args);
+            this->individual_tasks.insert(task);
+            (*num_jobs_in_system)++;
+        }
+    }
+
+    /**
+     * @brief Submit the ready tasks as job arrays of the tasks that request the same time and number of
+     *        nodes, as long as the number of jobs in the system allows it. The tasks are grouped in one pass,
+     *        and the arrays are submitted in the order of their first task.
+     * @param core_speed: the core speed
+     * @param num_jobs_in_system: the number of jobs in the system (updated)
+     * @param max_num_jobs: the maximum number of jobs in the system
+     */
+    void ProxyWMS::submitJobArrays(double core_speed, unsigned long *num_jobs_in_system, unsigned long max_num_jobs) {
+        if (*num_jobs_in_system >= max_num_jobs) {
+            return;
+        }
+
+        // (requested minutes, number of nodes) -> tasks, in ID order
+        std::map<std::pair<unsigned long, unsigned long>, std::vector<WorkflowTask *>> groups;
+        // (group, position of the first task in the group) of each job array, in the order of their first task
+        std::vector<std::pair<std::pair<unsigned long, unsigned long>, unsigned long>> arrays;
+
+        for (auto it = this->ready_tasks.begin(); it != this->ready_tasks.end();) {
+            WorkflowTask *task = *it;
+            // may have been submitted as part of a placeholder job since it was queued
+            if (task->getState() != WorkflowTask::State::READY) {
+                it = this->ready_tasks.erase(it);
+                continue;
+            }
+            unsigned long requested_execution_time =
+                    (unsigned long) (WorkflowUtil::getNominalFlops(task) / core_speed) *
+                    WorkflowUtil::getWalltimeFactor({task}, 1, core_speed);
+            auto key = std::make_pair(1 + requested_execution_time / 60, 1UL);
+            std::vector<WorkflowTask *> &group = groups[key];
+            if (group.size() % Globals::max_job_array_size == 0) {
+                arrays.push_back(std::make_pair(key, group.size()));
+            }
+            group.push_back(task);
+            ++it;
+        }
+
+        for (auto const &array : arrays) {
+            if (*num_jobs_in_system >= max_num_jobs) {
+                break;
+            }
+            std::vector<WorkflowTask *> &group = groups[array.first];
+            auto first = group.begin() + array.second;
+            auto last = group.begin() + std::min<unsigned long>(array.second + Globals::max_job_array_size,
+                                                                group.size());
+            std::vector<WorkflowTask *> array_tasks(first, last);
+            for (auto task : array_tasks) {
+                this->ready_tasks.erase(task);
+            }
+
+            WRENCH_INFO("Submitting %lu tasks individually, as a job array!", array_tasks.size());
+            this->individual_tasks.insert(array_tasks.begin(), array_tasks.end());
+            this->job_arrays.submit(this->job_manager, this->batch_service, array_tasks, array.first.first);
+            (*num_jobs_in_system)++;
+        }
+    }
+
+    /**
+     * @brief Record that a job submitted by submitAllOneJobPerTask() is done
+     * @param job: the job
+     * @return true if one fewer job is in the system, i.e., unless the job is an element of a job array that
+     *         has other elements that aren't done
+     */
+    bool ProxyWMS::completeIndividualJob(StandardJob *job) {
+        this->individual_tasks.erase(job->tasks[0]);
+        return this->job_arrays.completeElement(job);
+    }
+
+    /**
+     * @brief Check whether a job was submitted by submitAllOneJobPerTask()
+     * @param job: the job
+     * @return true or false
+     */
+    bool ProxyWMS::isIndividualJob(StandardJob *job) {
+        return this->individual_tasks.find(job->tasks[0]) != this->individual_tasks.end();
+    }
+
+    /**
+     * @brief Add the children that a task completion made ready to the ready set (no-op until
+     *        submitAllOneJobPerTask() has been called once)
+     * @param completed_task: the task that just completed
+     */
+    void ProxyWMS::enqueueReadyChildren(WorkflowTask *completed_task) {
+        if (not this->ready_tasks_initialized) {
+            return;
+        }
+        for (auto child : this->workflow->getTaskChildren(completed_task)) {
+            if (child->getState() == WorkflowTask::State::READY) {
+                this->ready_tasks.insert(child);
+            }
+        }
+    }
+
+    /**
+     * @brief Submit queued ready tasks to a running placeholder job, up to its number of hosts
+     * @param placeholder_job: a running placeholder job
+     */
+    void ProxyWMS::dispatchReadyTasks(PlaceHolderJob *placeholder_job) {
+        while (placeholder_job->num_standard_job_submitted < placeholder_job->num_hosts) {
+            WorkflowTask *task = placeholder_job->popReadyTask();
+            if (task == nullptr) {
+                break;
+            }
+            // may have been submitted some other way since it was queued (e.g., individually)
+            if (task->getState() != WorkflowTask::READY) {
+                continue;
             }
+
+            auto standard_job = this->job_manager->createStandardJob(task, {});
+            WRENCH_INFO("Submitting task %s as part of placeholder job %ld-%ld",
+                        task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
+            this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
+            placeholder_job->num_standard_job_submitted++;
         }
     }
 
+    /**
+     * @brief Forget the ready set so that the next submission rescans the workflow, for when tasks
+     *        became ready again without a completion (e.g., after a pilot job expiration)
+     */
+    void ProxyWMS::resetReadyTasks() {
+        this->ready_tasks.clear();
+        this->ready_tasks_initialized = false;
+    }
+
+    bool ProxyWMS::TaskIDComparator::operator()(WorkflowTask *t1, WorkflowTask *t2) const {
+        return t1->getID() < t2->getID();
+    }
+
     double ProxyWMS::findMaxDuration(std::set<wrench::PlaceHolderJob *> jobs) {
         double max_duration = 0;
         for (PlaceHolderJob *pj : jobs) {
@@ -104,6 +267,39 @@ namespace wrench {
         return wait_time_estimate;
     }
 
+    /**
+     * @brief Estimate the wait times of several jobs with a single query to the batch service
+     * @param configurations: a list of (parallelism, makespan) job configurations
+     * @param simulation_date: the current date
+     * @param sequence: a sequence number used to make job names unique (updated)
+     * @return the wait time of each configuration, in the same order
+     */
+    std::vector<double> ProxyWMS::estimateWaitTimes(std::vector<std::tuple<unsigned long, double>> configurations,
+                                                    double simulation_date, int *sequence) {
+        if (configurations.empty()) {
+            return {};
+        }
+
+        std::set<std::tuple<std::string, unsigned long, unsigned long, double>> job_config;
+        std::vector<std::string> config_keys;
+        for (auto const &config : configurations) {
+            std::string config_key = "config_XXXX_" + std::to_string((*sequence)++); // need to make it unique for BATSCHED
+            job_config.insert(std::make_tuple(config_key, std::get<0>(config), 1, std::get<1>(config)));
+            config_keys.push_back(config_key);
+        }
+        std::map<std::string, double> estimates = this->batch_service->getStartTimeEstimates(job_config);
+
+        std::vector<double> wait_time_estimates;
+        for (auto const &config_key : config_keys) {
+            if ((estimates.find(config_key) == estimates.end()) or (estimates[config_key] < 0)) {
+                throw std::runtime_error("Could not obtain start time estimate... aborting");
+            }
+            wait_time_estimates.push_back(std::max<double>(0, estimates[config_key] - simulation_date));
+        }
+
+        return wait_time_estimates;
+    }
+
     unsigned long ProxyWMS::getStartLevel(std::set<PlaceHolderJob *> running_placeholder_jobs) {
         unsigned long start_level = 0;
         for (unsigned long i = 0; i < this->workflow->getNumLevels(); i++) {
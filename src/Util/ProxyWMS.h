@@ -7,6 +7,8 @@
 
 //#define EXECUTION_TIME_FUDGE_FACTOR 2.1
 
+#include <Util/JobArrays.h>
+
 namespace wrench {
 
     class PlaceHolderJob;
@@ -25,20 +27,48 @@ namespace wrench {
 
         void submitAllOneJobPerTask(double core_speed, unsigned long * num_jobs_in_system, unsigned long max_num_jobs);
 
+        bool isIndividualJob(StandardJob *job);
+
+        bool completeIndividualJob(StandardJob *job);
+
+        void enqueueReadyChildren(WorkflowTask *completed_task);
+
+        void resetReadyTasks();
+
+        void dispatchReadyTasks(PlaceHolderJob *placeholder_job);
+
         static double findMaxDuration(std::set<PlaceHolderJob *> jobs);
 
         double estimateWaitTime(long parallelism, double makespan, double simulation_date, int *sequence);
 
+        std::vector<double> estimateWaitTimes(std::vector<std::tuple<unsigned long, double>> configurations,
+                                              double simulation_date, int *sequence);
+
         unsigned long getStartLevel(std::set<PlaceHolderJob *> running_placeholder_jobs);
 
     private:
 
+        void submitJobArrays(double core_speed, unsigned long *num_jobs_in_system, unsigned long max_num_jobs);
+
         Workflow *workflow;
 
         std::shared_ptr<JobManager> job_manager;
 
         std::shared_ptr<BatchComputeService> batch_service;
 
+        JobArrays job_arrays;
+
+        // Tasks submitted individually that haven't completed
+        std::set<WorkflowTask *> individual_tasks;
+
+        struct TaskIDComparator {
+            bool operator()(WorkflowTask *t1, WorkflowTask *t2) const;
+        };
+
+        // Ready tasks not yet submitted individually, in the same (ID) order as workflow->getTasks()
+        std::set<WorkflowTask *, TaskIDComparator> ready_tasks;
+        bool ready_tasks_initialized = false;
+
     };
 }
 
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "ThreadPool.h"
+
+namespace wrench {
+
+    /**
+     * @brief Constructor
+     * @param num_threads: the number of threads that run each batch, including the one that submits it
+     */
+    ThreadPool::ThreadPool(unsigned long num_threads) : next_item(0) {
+        this->batch_number = 0;
+        this->work = nullptr;
+        this->num_items = 0;
+        this->num_busy_workers = 0;
+        this->stopping = false;
+        for (unsigned long i = 1; i < num_threads; i++) {
+            this->workers.push_back(std::thread(&ThreadPool::runWorker, this));
+        }
+    }
+
+    /**
+     * @brief Destructor, which stops the threads
+     */
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->batch_started.notify_all();
+        for (auto &worker : this->workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Run a batch of work items, and return once they are all done. Items may run in any order and
+     *        concurrently. If items throw, the remaining items are skipped and the first exception is
+     *        rethrown here.
+     * @param num_items: the number of items
+     * @param work: the work, called with the index of each item
+     */
+    void ThreadPool::run(unsigned long num_items, const std::function<void(unsigned long)> &work) {
+        if (num_items == 0) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->work = &work;
+            this->num_items = num_items;
+            this->next_item = 0;
+            this->error = nullptr;
+            this->num_busy_workers = this->workers.size();
+            this->batch_number++;
+        }
+        this->batch_started.notify_all();
+
+        this->runItems();
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->batch_done.wait(lock, [this]() { return this->num_busy_workers == 0; });
+            this->work = nullptr;
+            error = this->error;
+            this->error = nullptr;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Run items of the current batch until there are none left
+     */
+    void ThreadPool::runItems() {
+        unsigned long i;
+        while ((i = this->next_item++) < this->num_items) {
+            try {
+                (*this->work)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (not this->error) {
+                    this->error = std::current_exception();
+                }
+                this->next_item = this->num_items;
+            }
+        }
+    }
+
+    /**
+     * @brief The loop of a worker thread: wait for a batch, help run it, and so on until the pool is destroyed
+     */
+    void ThreadPool::runWorker() {
+        unsigned long last_batch_number = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->batch_started.wait(lock, [this, last_batch_number]() {
+                    return this->stopping or (this->batch_number != last_batch_number);
+                });
+                if (this->stopping) {
+                    return;
+                }
+                last_batch_number = this->batch_number;
+            }
+
+            this->runItems();
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (--this->num_busy_workers == 0) {
+                    this->batch_done.notify_all();
+                }
+            }
+        }
+    }
+
+};
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef TASK_CLUSTERING_BATCH_SIMULATOR_THREADPOOL_H
+#define TASK_CLUSTERING_BATCH_SIMULATOR_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wrench {
+
+    /**
+     * @brief Threads that are started once and then run batches of independent work items (pure computation
+     *        that doesn't involve the simulation), along with the thread that submits each batch
+     */
+    class ThreadPool {
+
+    public:
+
+        explicit ThreadPool(unsigned long num_threads);
+
+        ~ThreadPool();
+
+        void run(unsigned long num_items, const std::function<void(unsigned long)> &work);
+
+    private:
+
+        void runItems();
+
+        void runWorker();
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable batch_started;
+        std::condition_variable batch_done;
+
+        // the current batch, which the workers tell apart from the previous one by its number
+        unsigned long batch_number;
+        const std::function<void(unsigned long)> *work;
+        unsigned long num_items;
+        std::atomic<unsigned long> next_item;
+        unsigned long num_busy_workers;
+        // the first exception thrown by a work item of the current batch, if any
+        std::exception_ptr error;
+
+        bool stopping;
+
+    };
+
+};
+
+
+#endif //TASK_CLUSTERING_BATCH_SIMULATOR_THREADPOOL_H
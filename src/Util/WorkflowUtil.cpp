@@ -17,8 +17,16 @@
 #include<mach/mach.h>
 #endif
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <cmath>
+#include <queue>
 
 #include "WorkflowUtil.h"
+#include "HostScans.h"
+#include "ThreadPool.h"
+#include "Globals.h"
+#include "Simulator.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(workflow_util, "Log category for Workflow Util");
 
@@ -27,6 +35,18 @@ namespace wrench {
 
     std::unordered_map<WorkflowTask*, std::vector<WorkflowTask*>> lineage;
 
+    // The threads that estimateMakespans() runs on
+    std::unique_ptr<ThreadPool> thread_pool;
+
+    // Nominal flops and coefficient of variation of each task's runtime (its actual flops are a sample)
+    std::unordered_map<const WorkflowTask*, std::pair<double, double>> runtime_models;
+
+    // Input and output files (by ID) of each task, and the size and consuming tasks of each file, for the
+    // staging cost model (the simulated tasks themselves have no files)
+    std::unordered_map<const WorkflowTask*, std::pair<std::vector<std::string>, std::vector<std::string>>> task_files;
+    std::unordered_map<std::string, double> file_sizes;
+    std::unordered_map<std::string, std::unordered_set<const WorkflowTask*>> file_consumers;
+
 #ifdef PRINT_RAM_MACOSX
     void WorkflowUtil::printRAM() {
 
@@ -48,21 +68,10 @@ namespace wrench {
 #endif
 
     /**
-     * @brief Estimate a workflow's makespan
-     * @param tasks: a set of tasks. For any task that has parents outside of this set, it is assumed that
-     *         those parents are completed. For instance, a task with no parents in this set is assumed ready.
-     *         If no task is given, then makespan will be zero.
-     * @param num_hosts
-     * @param core_speed
-     * @return
+     * @brief Fill the task -> parents map used by makespan estimates, if not done already
+     * @param tasks: some tasks of the workflow
      */
-    double WorkflowUtil::estimateMakespan(std::vector<WorkflowTask *> tasks,
-                                          unsigned long num_hosts, double core_speed) {
-
-        if (tasks.size() == 0) {
-            return 0.0;
-        }
-
+    static void initializeLineage(std::vector<WorkflowTask *> &tasks) {
         if (lineage.empty()) {
             auto workflow = (*tasks.begin())->getWorkflow();
             for (auto task : workflow->getTasks()) {
@@ -70,24 +79,26 @@ namespace wrench {
                 lineage[task] = parents;
             }
         }
+    }
 
-        if (num_hosts == 0) {
-            throw std::runtime_error("Cannot estimate makespan with 0 hosts!");
-        }
-
-//        // Sort the tasks
-//        std::sort(tasks.begin(), tasks.end(),
-//                  [](const WorkflowTask * t1, const WorkflowTask * t2) -> bool {
-//
-//                      if (t1->getFlops() == t2->getFlops()) {
-//                          return (t1->getID() > t2->getID());
-//                      }
-//                      return (t1->getFlops() > t2->getFlops());
-//                  });
-
-        // Initialize host idle dates
-        double idle_date[num_hosts];
-        memset(idle_date, 0, sizeof(double)*num_hosts);
+    /**
+     * @brief List-schedule tasks on hosts, starting from the current state of the hosts
+     * @param tasks: the tasks to schedule
+     * @param idle_date: the idle date of each host (updated)
+     * @param num_hosts: the number of hosts
+     * @param core_speed: the core speed
+     * @param fake_tasks: the completion date of each scheduled task (updated). A task that is not in
+     *        this map, nor in the tasks to schedule, is assumed completed at date 0.
+     * @param current_time: the date at which scheduling starts/resumes (updated)
+     * @param schedule: if not nullptr, the (task, host) pairs are appended to it in the order the tasks are started
+     * @param passes: if not nullptr (and schedule isn't either), the current date at the start of each pass over the
+     *        tasks and the size of the schedule at that point are appended to it
+     */
+    static void scheduleTasks(std::vector<WorkflowTask *> &tasks, double *idle_date, unsigned long num_hosts,
+                              double core_speed, std::unordered_map<WorkflowTask *, double> &fake_tasks,
+                              double &current_time,
+                              std::vector<std::tuple<WorkflowTask *, unsigned long>> *schedule = nullptr,
+                              std::vector<std::pair<double, unsigned long>> *passes = nullptr) {
 
         unsigned long num_tasks = tasks.size();
 
@@ -96,18 +107,17 @@ namespace wrench {
             tasks_to_schedule.insert(task);
         }
 
-        // Create a list of "fake" tasks
-        std::unordered_map<WorkflowTask *, double> fake_tasks;  // WorkflowTask, completion time
-
         // Insert all fake_tasks
         for (auto task : tasks_to_schedule) {
             fake_tasks[task] = -1.0;
         }
 
         unsigned long num_scheduled_tasks = 0;
-        double current_time = 0.0;
 
         while (num_scheduled_tasks < num_tasks) {
+            if (passes) {
+                passes->push_back(std::make_pair(current_time, schedule->size()));
+            }
             bool scheduled_something = false;
             std::set<WorkflowTask *> tasks_scheduled;
 
@@ -116,11 +126,15 @@ namespace wrench {
                 //WRENCH_INFO("LOOKING AT TASK %s", real_task->getID().c_str());
                 // Determine whether the task is schedulable
                 bool schedulable = true;
-                for (auto const &parent : lineage[real_task]) {
-                    if ((fake_tasks[parent] > current_time) or
-                        (fake_tasks[parent] < 0)) {
-                        schedulable = false;
-                        break;
+                // (look up without inserting, as estimates may run in several threads)
+                auto parents = lineage.find(real_task);
+                if (parents != lineage.end()) {
+                    for (auto const &parent : parents->second) {
+                        if ((fake_tasks[parent] > current_time) or
+                            (fake_tasks[parent] < 0)) {
+                            schedulable = false;
+                            break;
+                        }
                     }
                 }
 
@@ -129,21 +143,19 @@ namespace wrench {
                     continue;
                 }
 
-                double task_end_time = current_time + real_task->getFlops() / core_speed;
-                for (unsigned int j=0; j < num_hosts; j++) {
-//            WRENCH_INFO("LOOKING AT HOST %d: %.2lf", j, idle_date[j]);
-                    if (idle_date[j] <= current_time) {
+                double task_end_time = current_time + WorkflowUtil::getNominalFlops(real_task) / core_speed;
+                unsigned long j = HostScans::findFirstAtMost(idle_date, num_hosts, current_time);
+                if (j < num_hosts) {
 //              WRENCH_INFO("SCHEDULING TASK on HOST %d", j);
-                        fake_tasks[real_task] = task_end_time;
-                        idle_date[j] = task_end_time;
+                    fake_tasks[real_task] = task_end_time;
+                    idle_date[j] = task_end_time;
 //              WRENCH_INFO("SCHEDULED TASK %s on host %d from time %.2lf-%.2lf",
 //                          real_task->getID().c_str(), j, current_time,
 //                          current_time + real_task->getFlops() / core_speed);
-                        scheduled_something = true;
-                        tasks_scheduled.insert(real_task);
-                        break;
-                    } else {
-//              WRENCH_INFO("THIS HOST DOESN'T WORK");
+                    scheduled_something = true;
+                    tasks_scheduled.insert(real_task);
+                    if (schedule) {
+                        schedule->push_back(std::make_tuple(real_task, j));
                     }
                 }
             }
@@ -156,29 +168,821 @@ namespace wrench {
 //        WRENCH_INFO("UPDATING CURRENT TIME");
             if (scheduled_something) {
                 // Set current time to min idle time
-                double min_idle_time = idle_date[0];
-                for (unsigned int j = 1; j < num_hosts; j++) {
-                    min_idle_time = std::min<double>(idle_date[j], min_idle_time);
+                current_time = HostScans::getMin(idle_date, num_hosts);
+            } else {
+                current_time = HostScans::getMinAbove(idle_date, num_hosts, current_time);
+            }
+//        WRENCH_INFO("UPDATED CURRENT TIME TO %.2lf", current_time);
+        }
+    }
+
+    /**
+     * @brief Find out whether a set of tasks has a shape whose makespan has a closed form: no dependencies
+     *        between the tasks (e.g., a level), or a single chain
+     * @param tasks: a set of tasks (same assumptions as for estimateMakespan())
+     * @param chain: the tasks in dependency order, if they form a chain (filled)
+     * @return true if the tasks are independent (chain is then left empty) or form a chain
+     */
+    static bool isIndependentSetOrChain(std::vector<WorkflowTask *> &tasks, std::vector<WorkflowTask *> &chain) {
+        std::unordered_set<WorkflowTask *> task_set(tasks.begin(), tasks.end());
+        if (task_set.size() != tasks.size()) {
+            return false;
+        }
+
+        // The parent and the child of each task in the set, if any (there can't be more than one of each)
+        std::unordered_map<WorkflowTask *, WorkflowTask *> parent_in_set;
+        std::unordered_map<WorkflowTask *, WorkflowTask *> child_in_set;
+        for (auto task : tasks) {
+            auto parents = lineage.find(task);
+            if (parents == lineage.end()) {
+                continue;
+            }
+            for (auto parent : parents->second) {
+                if (task_set.find(parent) == task_set.end()) {
+                    continue;
                 }
-                current_time = min_idle_time;
+                if ((parent_in_set.find(task) != parent_in_set.end()) or
+                    (child_in_set.find(parent) != child_in_set.end())) {
+                    return false;
+                }
+                parent_in_set[task] = parent;
+                child_in_set[parent] = task;
+            }
+        }
+        if (parent_in_set.empty()) {
+            return true;
+        }
+
+        // A chain has a single task without a parent, from which all the others can be reached
+        WorkflowTask *first_task = nullptr;
+        for (auto task : tasks) {
+            if (parent_in_set.find(task) == parent_in_set.end()) {
+                if (first_task != nullptr) {
+                    return false;
+                }
+                first_task = task;
+            }
+        }
+        for (WorkflowTask *task = first_task; task != nullptr;) {
+            chain.push_back(task);
+            auto child = child_in_set.find(task);
+            task = (child == child_in_set.end() ? nullptr : child->second);
+        }
+        return chain.size() == tasks.size();
+    }
+
+    /**
+     * @brief Compute the makespan that scheduleTasks() gives independent tasks, without its passes over the
+     *        tasks: each task, in the order of the scheduler's task set, starts on the host that is idle first
+     *        (the lowest-numbered one among those idle at the same date)
+     * @param tasks: independent tasks
+     * @param num_hosts: the number of hosts
+     * @param core_speed: the core speed
+     * @return the makespan
+     */
+    static double scheduleIndependentTasks(std::vector<WorkflowTask *> tasks, unsigned long num_hosts,
+                                           double core_speed) {
+        std::sort(tasks.begin(), tasks.end(), std::less<WorkflowTask *>());
+
+        // A host is only used if all the lower-numbered ones are busy, so there is no need for more hosts than tasks
+        std::priority_queue<std::pair<double, unsigned long>, std::vector<std::pair<double, unsigned long>>,
+                std::greater<std::pair<double, unsigned long>>> hosts;
+        for (unsigned long j = 0; j < std::min<unsigned long>(num_hosts, tasks.size()); j++) {
+            hosts.push(std::make_pair(0.0, j));
+        }
+
+        double makespan = 0.0;
+        for (auto task : tasks) {
+            std::pair<double, unsigned long> host = hosts.top();
+            hosts.pop();
+            double task_end_time = host.first + WorkflowUtil::getNominalFlops(task) / core_speed;
+            makespan = std::max<double>(makespan, task_end_time);
+            hosts.push(std::make_pair(task_end_time, host.second));
+        }
+        return makespan;
+    }
+
+    /**
+     * @brief Estimate a workflow's makespan
+     * @param tasks: a set of tasks. For any task that has parents outside of this set, it is assumed that
+     *         those parents are completed. For instance, a task with no parents in this set is assumed ready.
+     *         If no task is given, then makespan will be zero.
+     * @param num_hosts
+     * @param core_speed
+     * @return
+     */
+    double WorkflowUtil::estimateMakespan(std::vector<WorkflowTask *> tasks,
+                                          unsigned long num_hosts, double core_speed) {
+
+        if (tasks.size() == 0) {
+            return 0.0;
+        }
+
+        initializeLineage(tasks);
+
+        if (num_hosts == 0) {
+            throw std::runtime_error("Cannot estimate makespan with 0 hosts!");
+        }
+
+//        // Sort the tasks
+//        std::sort(tasks.begin(), tasks.end(),
+//                  [](const WorkflowTask * t1, const WorkflowTask * t2) -> bool {
+//
+//                      if (t1->getFlops() == t2->getFlops()) {
+//                          return (t1->getID() > t2->getID());
+//                      }
+//                      return (t1->getFlops() > t2->getFlops());
+//                  });
+
+        // Independent tasks (e.g., a level) and chains have closed forms, which give the same makespan as the
+        // list scheduling below
+        std::vector<WorkflowTask *> chain;
+        if (isIndependentSetOrChain(tasks, chain)) {
+            double makespan = 0.0;
+            if (chain.empty()) {
+                makespan = scheduleIndependentTasks(tasks, num_hosts, core_speed);
             } else {
-                double second_min_idle_time = DBL_MAX;
-                for (unsigned int j = 0; j < num_hosts; j++) {
-                    if (idle_date[j] > current_time) {
-                        second_min_idle_time = std::min<double>(idle_date[j], second_min_idle_time);
+                for (auto task : chain) {
+                    makespan += getNominalFlops(task) / core_speed;
+                }
+            }
+            return makespan + getStagingTime(tasks);
+        }
+
+        // Initialize host idle dates
+        double idle_date[num_hosts];
+        memset(idle_date, 0, sizeof(double)*num_hosts);
+
+        // Create a list of "fake" tasks
+        std::unordered_map<WorkflowTask *, double> fake_tasks;  // WorkflowTask, completion time
+
+        double current_time = 0.0;
+
+        scheduleTasks(tasks, idle_date, num_hosts, core_speed, fake_tasks, current_time);
+
+        double makespan = HostScans::getMax(idle_date, num_hosts);
+
+        return makespan + getStagingTime(tasks);
+
+    }
+
+    /**
+     * @brief Estimate the makespans of several task sets / numbers of hosts, using Globals::num_threads
+     *        threads. This is pure computation that doesn't involve the simulation. An exception thrown
+     *        by one of the estimates is rethrown here.
+     * @param configurations: a list of (tasks, num_hosts) configurations
+     * @param core_speed: the core speed
+     * @return the makespan of each configuration, in the same order
+     */
+    std::vector<double>
+    WorkflowUtil::estimateMakespans(std::vector<std::tuple<std::vector<WorkflowTask *> *, unsigned long>> configurations,
+                                    double core_speed) {
+
+        std::vector<double> makespans(configurations.size(), 0.0);
+
+        // Fill the lineage before any thread reads it
+        for (auto const &config : configurations) {
+            if (not std::get<0>(config)->empty()) {
+                initializeLineage(*std::get<0>(config));
+                break;
+            }
+        }
+
+        // The threads are started on the first call, once Globals::num_threads is known
+        if (not thread_pool) {
+            thread_pool.reset(new ThreadPool(Globals::num_threads));
+        }
+        thread_pool->run(configurations.size(), [&configurations, &makespans, core_speed](unsigned long i) {
+            makespans[i] = estimateMakespan(*std::get<0>(configurations[i]), std::get<1>(configurations[i]),
+                                            core_speed);
+        });
+
+        return makespans;
+    }
+
+    /**
+     * @brief Compute the quantities that bound the makespan of a set of tasks from below, whatever the number of hosts
+     * @param tasks: a set of tasks (same assumptions as for estimateMakespan())
+     * @param core_speed: the core speed
+     * @return (critical path length, total work, longest task), in seconds
+     */
+    std::tuple<double, double, double> WorkflowUtil::getMakespanBounds(std::vector<WorkflowTask *> tasks,
+                                                                         double core_speed) {
+        if (tasks.empty()) {
+            return std::make_tuple(0.0, 0.0, 0.0);
+        }
+
+        initializeLineage(tasks);
+
+        // Completion date of each task when started as soon as its parents in the set are done
+        std::unordered_map<WorkflowTask *, double> end_dates;
+        for (auto task : tasks) {
+            end_dates[task] = -1.0;
+        }
+
+        double critical_path = 0.0;
+        double work = 0.0;
+        double longest_task = 0.0;
+        std::vector<WorkflowTask *> stack;
+        for (auto task : tasks) {
+            stack.push_back(task);
+            while (not stack.empty()) {
+                WorkflowTask *current = stack.back();
+                if (end_dates[current] >= 0) {
+                    stack.pop_back();
+                    continue;
+                }
+
+                // Compute the parents first
+                double start_date = 0.0;
+                bool parents_done = true;
+                auto parents = lineage.find(current);
+                if (parents != lineage.end()) {
+                    for (auto parent : parents->second) {
+                        auto parent_end_date = end_dates.find(parent);
+                        if (parent_end_date == end_dates.end()) {
+                            continue;
+                        }
+                        if (parent_end_date->second < 0) {
+                            stack.push_back(parent);
+                            parents_done = false;
+                        } else {
+                            start_date = std::max<double>(start_date, parent_end_date->second);
+                        }
                     }
                 }
-                current_time = second_min_idle_time;
+                if (not parents_done) {
+                    continue;
+                }
+
+                double duration = getNominalFlops(current) / core_speed;
+                end_dates[current] = start_date + duration;
+                critical_path = std::max<double>(critical_path, end_dates[current]);
+                work += duration;
+                longest_task = std::max<double>(longest_task, duration);
+                stack.pop_back();
             }
-//        WRENCH_INFO("UPDATED CURRENT TIME TO %.2lf", current_time);
         }
 
-        double makespan = idle_date[0];
-        for (unsigned int i=1; i < num_hosts; i++) {
-            makespan = std::max<double>(makespan, idle_date[i]);
+        return std::make_tuple(critical_path, work, longest_task);
+    }
+
+    /**
+     * @brief Get a lower bound on the makespan estimated by estimateMakespan()
+     * @param bounds: the bounds returned by getMakespanBounds()
+     * @param num_hosts: the number of hosts
+     * @return the lower bound (a hair below, so that rounding errors can't make it exceed the estimate)
+     */
+    double WorkflowUtil::getMakespanLowerBound(std::tuple<double, double, double> bounds, unsigned long num_hosts) {
+        double bound = std::max<double>(std::get<0>(bounds), std::get<2>(bounds));
+        if (num_hosts > 0) {
+            bound = std::max<double>(bound, std::get<1>(bounds) / num_hosts);
         }
+        return bound * (1 - 1e-9);
+    }
 
-        return makespan;
+    /**
+     * @brief Split candidates into batches to evaluate in turn, by increasing lower bound, each batch
+     *        being twice as large as the previous one. The most promising candidates are then evaluated
+     *        first (and together, e.g., in parallel), so that the others can be pruned.
+     * @param bounds: the lower bound of each candidate
+     * @param first_batch_size: the size of the first batch
+     * @return batches of candidate indices
+     */
+    std::vector<std::vector<unsigned long>> WorkflowUtil::getBatchesByBound(std::vector<double> &bounds,
+                                                                           unsigned long first_batch_size) {
+        std::vector<unsigned long> order;
+        for (unsigned long c = 0; c < bounds.size(); c++) {
+            order.push_back(c);
+        }
+        std::stable_sort(order.begin(), order.end(), [&bounds](unsigned long c1, unsigned long c2) -> bool {
+            return bounds[c1] < bounds[c2];
+        });
+
+        std::vector<std::vector<unsigned long>> batches;
+        unsigned long batch_size = std::max<unsigned long>(1, first_batch_size);
+        for (unsigned long c = 0; c < order.size(); c += batch_size, batch_size *= 2) {
+            batches.push_back(std::vector<unsigned long>(
+                    order.begin() + c, order.begin() + std::min<unsigned long>(order.size(), c + batch_size)));
+        }
+        return batches;
+    }
+
+    /**
+     * @brief Set the runtime model of a task
+     * @param task: the task
+     * @param nominal_flops: the flops that estimates should use (the mean of the actual flops)
+     * @param cv: the coefficient of variation of the actual flops (0 if they are the nominal flops)
+     */
+    void WorkflowUtil::setRuntimeModel(const WorkflowTask *task, double nominal_flops, double cv) {
+        runtime_models[task] = std::make_pair(nominal_flops, cv);
+    }
+
+    /**
+     * @brief Get the flops of a task that estimates should use
+     * @param task: the task
+     * @return the nominal flops (the actual flops for a task without a runtime model)
+     */
+    double WorkflowUtil::getNominalFlops(const WorkflowTask *task) {
+        auto it = runtime_models.find(task);
+        if (it == runtime_models.end()) {
+            return task->getFlops();
+        }
+        return it->second.first;
+    }
+
+    /**
+     * @brief Get the coefficient of variation of a task's flops
+     * @param task: the task
+     * @return the coefficient of variation (0 for a task without a runtime model)
+     */
+    double WorkflowUtil::getRuntimeCV(const WorkflowTask *task) {
+        auto it = runtime_models.find(task);
+        if (it == runtime_models.end()) {
+            return 0.0;
+        }
+        return it->second.second;
+    }
+
+    /**
+     * @brief Record an input or output file of a task, for the staging cost model
+     * @param task: the task
+     * @param file_id: the file's ID
+     * @param size: the file's size, in bytes
+     * @param is_input: whether the task reads the file (otherwise, it writes it)
+     */
+    void WorkflowUtil::addTaskFile(const WorkflowTask *task, std::string file_id, double size, bool is_input) {
+        file_sizes[file_id] = size;
+        if (is_input) {
+            task_files[task].first.push_back(file_id);
+            file_consumers[file_id].insert(task);
+        } else {
+            task_files[task].second.push_back(file_id);
+        }
+    }
+
+    /**
+     * @brief Give a task that replaces a parent and its single child the files of both, except for the
+     *        files that the parent writes for the child only
+     * @param merged_task: the task that replaces them
+     * @param parent: the parent
+     * @param child: the child
+     */
+    void WorkflowUtil::mergeTaskFiles(const WorkflowTask *merged_task, const WorkflowTask *parent,
+                                      const WorkflowTask *child) {
+        if (task_files.empty()) {
+            return;
+        }
+        auto &merged_files = task_files[merged_task];
+        for (auto const &file_id : task_files[parent].first) {
+            merged_files.first.push_back(file_id);
+        }
+        for (auto const &file_id : task_files[child].first) {
+            auto const &parent_outputs = task_files[parent].second;
+            if (std::find(parent_outputs.begin(), parent_outputs.end(), file_id) == parent_outputs.end()) {
+                merged_files.first.push_back(file_id);
+            }
+        }
+        for (auto const &file_id : task_files[parent].second) {
+            merged_files.second.push_back(file_id);
+        }
+        for (auto const &file_id : task_files[child].second) {
+            merged_files.second.push_back(file_id);
+        }
+
+        for (auto const &task : {parent, child}) {
+            for (auto const &file_id : task_files[task].first) {
+                file_consumers[file_id].erase(task);
+            }
+            task_files.erase(task);
+        }
+        for (auto const &file_id : merged_files.first) {
+            file_consumers[file_id].insert(merged_task);
+        }
+    }
+
+    /**
+     * @brief Get the input files of a task
+     * @param task: the task
+     * @return a list of (file ID, size in bytes) pairs
+     */
+    std::vector<std::pair<std::string, double>> WorkflowUtil::getInputFiles(const WorkflowTask *task) {
+        std::vector<std::pair<std::string, double>> input_files;
+        auto it = task_files.find(task);
+        if (it != task_files.end()) {
+            for (auto const &file_id : it->second.first) {
+                input_files.push_back(std::make_pair(file_id, file_sizes[file_id]));
+            }
+        }
+        return input_files;
+    }
+
+    /**
+     * @brief Get the bytes that a job running some tasks stages in (the files they read that none of them
+     *        writes) and out (the files they write that another task reads, or that no task reads)
+     * @param tasks: the tasks
+     * @return the stage-in and stage-out bytes
+     */
+    std::pair<double, double> WorkflowUtil::getStagedBytes(std::vector<WorkflowTask *> tasks) {
+        if (task_files.empty()) {
+            return std::make_pair(0.0, 0.0);
+        }
+
+        std::unordered_set<const WorkflowTask *> job_tasks(tasks.begin(), tasks.end());
+        std::unordered_set<std::string> written_files;
+        for (auto t : tasks) {
+            auto it = task_files.find(t);
+            if (it != task_files.end()) {
+                written_files.insert(it->second.second.begin(), it->second.second.end());
+            }
+        }
+
+        double stage_in_bytes = 0;
+        double stage_out_bytes = 0;
+        std::unordered_set<std::string> staged_in_files;
+        for (auto t : tasks) {
+            auto it = task_files.find(t);
+            if (it == task_files.end()) {
+                continue;
+            }
+            for (auto const &file_id : it->second.first) {
+                if ((written_files.find(file_id) == written_files.end()) and
+                    staged_in_files.insert(file_id).second) {
+                    stage_in_bytes += file_sizes.at(file_id);
+                }
+            }
+            for (auto const &file_id : it->second.second) {
+                // lookups only, as estimates run in several threads (a file that no task reads has no entry)
+                auto consumers = file_consumers.find(file_id);
+                bool read_elsewhere = (consumers == file_consumers.end()) or consumers->second.empty();
+                if (not read_elsewhere) {
+                    for (auto consumer : consumers->second) {
+                        if (job_tasks.find(consumer) == job_tasks.end()) {
+                            read_elsewhere = true;
+                            break;
+                        }
+                    }
+                }
+                if (read_elsewhere) {
+                    stage_out_bytes += file_sizes.at(file_id);
+                }
+            }
+        }
+        return std::make_pair(stage_in_bytes, stage_out_bytes);
+    }
+
+    /**
+     * @brief Get the time a job running some tasks spends staging files in and out (--staging-bandwidth)
+     * @param tasks: the tasks
+     * @return a duration, in seconds (0 if staging isn't modeled)
+     */
+    double WorkflowUtil::getStagingTime(std::vector<WorkflowTask *> tasks) {
+        if (Globals::staging_bandwidth <= 0) {
+            return 0.0;
+        }
+        std::pair<double, double> staged_bytes = getStagedBytes(tasks);
+        return (staged_bytes.first + staged_bytes.second) / Globals::staging_bandwidth;
+    }
+
+    /**
+     * @brief Sample flops from a lognormal distribution
+     * @param nominal_flops: the mean of the distribution
+     * @param cv: the coefficient of variation of the distribution
+     * @param rng: the random number generator
+     * @return a sample (the nominal flops if cv is 0)
+     */
+    double WorkflowUtil::sampleFlops(double nominal_flops, double cv, std::default_random_engine &rng) {
+        if ((cv <= 0) or (nominal_flops <= 0)) {
+            return nominal_flops;
+        }
+        double sigma = std::sqrt(std::log(1 + cv * cv));
+        double mu = std::log(nominal_flops) - sigma * sigma / 2;
+        std::lognormal_distribution<double> distribution(mu, sigma);
+        return distribution(rng);
+    }
+
+    /**
+     * @brief Estimate quantiles of a workflow's makespan when task runtimes vary. The schedule (host
+     *        assignment and task order on each host) is the one computed with nominal runtimes, and it
+     *        is replayed for all samples at once, one task at a time. As in estimateMakespan(), each
+     *        sample includes the (fixed) staging time.
+     * @param tasks: a set of tasks (same assumptions as for estimateMakespan())
+     * @param num_hosts: the number of hosts
+     * @param core_speed: the core speed
+     * @param probabilities: the probabilities (in [0,1]) of the quantiles to compute
+     * @param num_samples: the number of samples
+     * @return the quantiles, in the same order as the probabilities
+     */
+    std::vector<double>
+    WorkflowUtil::estimateMakespanQuantiles(std::vector<WorkflowTask *> tasks, unsigned long num_hosts,
+                                            double core_speed, std::vector<double> probabilities,
+                                            unsigned long num_samples) {
+
+        std::vector<double> quantiles(probabilities.size(), 0.0);
+        if ((tasks.size() == 0) or (num_samples == 0)) {
+            return quantiles;
+        }
+
+        initializeLineage(tasks);
+
+        if (num_hosts == 0) {
+            throw std::runtime_error("Cannot estimate makespan with 0 hosts!");
+        }
+
+        // Compute the nominal schedule
+        std::vector<double> idle_date(num_hosts, 0.0);
+        std::unordered_map<WorkflowTask *, double> fake_tasks;
+        double current_time = 0.0;
+        std::vector<std::tuple<WorkflowTask *, unsigned long>> schedule;
+        scheduleTasks(tasks, idle_date.data(), num_hosts, core_speed, fake_tasks, current_time, &schedule);
+
+        // Replay it: sample s of the dates of task k (host h) is at index k * num_samples + s (h * num_samples + s)
+        std::default_random_engine rng(Globals::runtime_seed);
+        std::unordered_map<WorkflowTask *, unsigned long> task_indices;
+        std::vector<double> end_dates(schedule.size() * num_samples);
+        std::vector<double> host_dates(num_hosts * num_samples, 0.0);
+        std::vector<double> runtimes(num_samples);
+
+        for (unsigned long k = 0; k < schedule.size(); k++) {
+            WorkflowTask *task = std::get<0>(schedule[k]);
+            double *host_date = &(host_dates[std::get<1>(schedule[k]) * num_samples]);
+            double *end_date = &(end_dates[k * num_samples]);
+
+            double nominal_flops = getNominalFlops(task);
+            double cv = getRuntimeCV(task);
+            for (unsigned long s = 0; s < num_samples; s++) {
+                runtimes[s] = sampleFlops(nominal_flops, cv, rng) / core_speed;
+            }
+
+            // Start when the host is idle and all parents are done
+            for (unsigned long s = 0; s < num_samples; s++) {
+                end_date[s] = host_date[s];
+            }
+            auto parents = lineage.find(task);
+            if (parents != lineage.end()) {
+                for (auto parent : parents->second) {
+                    auto parent_index = task_indices.find(parent);
+                    if (parent_index == task_indices.end()) {
+                        continue;
+                    }
+                    const double *parent_end_date = &(end_dates[parent_index->second * num_samples]);
+                    for (unsigned long s = 0; s < num_samples; s++) {
+                        end_date[s] = std::max<double>(end_date[s], parent_end_date[s]);
+                    }
+                }
+            }
+
+            for (unsigned long s = 0; s < num_samples; s++) {
+                end_date[s] += runtimes[s];
+                host_date[s] = end_date[s];
+            }
+            task_indices[task] = k;
+        }
+
+        std::vector<double> makespans(num_samples, 0.0);
+        for (unsigned long h = 0; h < num_hosts; h++) {
+            for (unsigned long s = 0; s < num_samples; s++) {
+                makespans[s] = std::max<double>(makespans[s], host_dates[h * num_samples + s]);
+            }
+        }
+        double staging_time = getStagingTime(tasks);
+        for (unsigned long s = 0; s < num_samples; s++) {
+            makespans[s] += staging_time;
+        }
+        std::sort(makespans.begin(), makespans.end());
+
+        for (unsigned long q = 0; q < probabilities.size(); q++) {
+            double rank = std::ceil(probabilities[q] * num_samples);
+            unsigned long index = (rank < 1 ? 0 : std::min<unsigned long>(num_samples - 1, (unsigned long) rank - 1));
+            quantiles[q] = makespans[index];
+        }
+
+        return quantiles;
+    }
+
+    /**
+     * @brief Get the factor by which to multiply the estimated makespan of a job to obtain its requested
+     *        time: EXECUTION_TIME_FUDGE_FACTOR, or, with an expiration probability p, the (1-p) quantile of the
+     *        makespan divided by its nominal value
+     * @param tasks: the job's tasks
+     * @param num_hosts: the job's number of hosts
+     * @param core_speed: the core speed
+     * @return the factor
+     */
+    double WorkflowUtil::getWalltimeFactor(std::vector<WorkflowTask *> tasks, unsigned long num_hosts,
+                                           double core_speed) {
+        if (Globals::expiration_probability <= 0) {
+            return EXECUTION_TIME_FUDGE_FACTOR;
+        }
+
+        double nominal_makespan = estimateMakespan(tasks, num_hosts, core_speed);
+        if (nominal_makespan <= 0) {
+            return 1.0;
+        }
+        double makespan = estimateMakespanQuantiles(tasks, num_hosts, core_speed,
+                                                    {1.0 - Globals::expiration_probability})[0];
+        return std::max<double>(1.0, makespan / nominal_makespan);
+    }
+
+    /**
+     * @brief Split the hosts of a job into at most max_num_allocations allocations with different durations, so
+     *        that the hosts that run out of work early can be released early. Hosts are grouped by the date at which
+     *        they become idle in the estimated schedule, picking the grouping that minimizes the reserved
+     *        node-seconds. This is only possible if the tasks don't depend on one another.
+     * @param tasks: the job's tasks
+     * @param num_hosts: the job's number of hosts
+     * @param core_speed: the core speed
+     * @param max_num_allocations: the maximum number of allocations
+     * @return a list of (tasks, number of hosts) allocations, ordered by increasing duration (the whole job if it
+     *         can't be split)
+     */
+    std::vector<std::tuple<std::vector<WorkflowTask *>, unsigned long>>
+    WorkflowUtil::getStaggeredAllocations(std::vector<WorkflowTask *> tasks, unsigned long num_hosts,
+                                          double core_speed, unsigned long max_num_allocations) {
+
+        std::vector<std::tuple<std::vector<WorkflowTask *>, unsigned long>> allocations;
+        allocations.push_back(std::make_tuple(tasks, num_hosts));
+        if ((tasks.size() < 2) or (num_hosts < 2) or (max_num_allocations < 2)) {
+            return allocations;
+        }
+
+        initializeLineage(tasks);
+
+        // Tasks that run in different allocations must not depend on one another
+        std::set<WorkflowTask *> task_set(tasks.begin(), tasks.end());
+        for (auto task : tasks) {
+            for (auto parent : lineage[task]) {
+                if (task_set.find(parent) != task_set.end()) {
+                    return allocations;
+                }
+            }
+        }
+
+        // Compute the schedule, and the tasks and idle date of each host
+        std::vector<double> idle_date(num_hosts, 0.0);
+        std::unordered_map<WorkflowTask *, double> fake_tasks;
+        double current_time = 0.0;
+        std::vector<std::tuple<WorkflowTask *, unsigned long>> schedule;
+        scheduleTasks(tasks, idle_date.data(), num_hosts, core_speed, fake_tasks, current_time, &schedule);
+
+        std::vector<std::vector<WorkflowTask *>> host_tasks(num_hosts);
+        for (auto const &scheduled_task : schedule) {
+            host_tasks[std::get<1>(scheduled_task)].push_back(std::get<0>(scheduled_task));
+        }
+
+        // Hosts that run something, by increasing idle date
+        std::vector<unsigned long> hosts;
+        for (unsigned long h = 0; h < num_hosts; h++) {
+            if (not host_tasks[h].empty()) {
+                hosts.push_back(h);
+            }
+        }
+        std::stable_sort(hosts.begin(), hosts.end(), [&idle_date](unsigned long h1, unsigned long h2) -> bool {
+            return idle_date[h1] < idle_date[h2];
+        });
+
+        // cost[g][i]: minimum reserved node-seconds of the first i hosts in g+1 allocations, where an allocation
+        // of consecutive hosts j..i-1 reserves (i-j) hosts until the idle date of host i-1
+        unsigned long n = hosts.size();
+        unsigned long num_allocations = std::min<unsigned long>(max_num_allocations, n);
+        std::vector<std::vector<double>> cost(num_allocations, std::vector<double>(n + 1, DBL_MAX));
+        std::vector<std::vector<unsigned long>> first_host(num_allocations, std::vector<unsigned long>(n + 1, 0));
+        for (unsigned long i = 1; i <= n; i++) {
+            cost[0][i] = i * idle_date[hosts[i - 1]];
+        }
+        for (unsigned long g = 1; g < num_allocations; g++) {
+            for (unsigned long i = g + 1; i <= n; i++) {
+                for (unsigned long j = g; j < i; j++) {
+                    double c = cost[g - 1][j] + (i - j) * idle_date[hosts[i - 1]];
+                    if (c < cost[g][i]) {
+                        cost[g][i] = c;
+                        first_host[g][i] = j;
+                    }
+                }
+            }
+        }
+
+        // Fewer allocations if they don't reserve fewer node-seconds
+        unsigned long best_g = 0;
+        for (unsigned long g = 1; g < num_allocations; g++) {
+            if (cost[g][n] < cost[best_g][n]) {
+                best_g = g;
+            }
+        }
+        if (best_g == 0) {
+            return allocations;
+        }
+
+        allocations.clear();
+        unsigned long i = n;
+        for (long g = (long) best_g; g >= 0; g--) {
+            unsigned long j = (g == 0) ? 0 : first_host[g][i];
+            std::vector<WorkflowTask *> allocation_tasks;
+            for (unsigned long k = j; k < i; k++) {
+                allocation_tasks.insert(allocation_tasks.end(), host_tasks[hosts[k]].begin(),
+                                        host_tasks[hosts[k]].end());
+            }
+            allocations.insert(allocations.begin(), std::make_tuple(allocation_tasks, i - j));
+            i = j;
+        }
+
+        return allocations;
+    }
+
+    /**
+     * @brief Constructor
+     * @param num_hosts: the number of hosts
+     * @param core_speed: the core speed
+     */
+    PartialSchedule::PartialSchedule(unsigned long num_hosts, double core_speed) {
+        this->num_hosts = num_hosts;
+        this->core_speed = core_speed;
+        this->idle_date = std::vector<double>(num_hosts, 0.0);
+        this->current_time = 0.0;
+    }
+
+    /**
+     * @brief Schedule more tasks along with the ones already scheduled, with the same result as scheduling all
+     *        of them at once: the schedule is rewound to the first pass over the tasks at which one of the new
+     *        tasks could have been ready, and resumed from there with the new tasks, so that they can fill the
+     *        hosts left idle before the end of the current schedule
+     * @param tasks: tasks whose parents are either already scheduled, in this set, or assumed completed
+     */
+    void PartialSchedule::addTasks(std::vector<WorkflowTask *> tasks) {
+        if (tasks.size() == 0) {
+            return;
+        }
+
+        initializeLineage(tasks);
+
+        if (this->num_hosts == 0) {
+            throw std::runtime_error("Cannot estimate makespan with 0 hosts!");
+        }
+
+        // The earliest date at which a new task can be ready: a task with a parent among the new tasks
+        // can't be ready before that parent is, and a parent that isn't scheduled is assumed completed at 0
+        std::unordered_set<WorkflowTask *> new_tasks(tasks.begin(), tasks.end());
+        double earliest_ready_date = DBL_MAX;
+        for (auto task : tasks) {
+            double ready_date = 0.0;
+            auto parents = lineage.find(task);
+            if (parents != lineage.end()) {
+                for (auto parent : parents->second) {
+                    if (new_tasks.find(parent) != new_tasks.end()) {
+                        ready_date = DBL_MAX;
+                        break;
+                    }
+                    auto completion_date = this->completion_dates.find(parent);
+                    if (completion_date != this->completion_dates.end()) {
+                        ready_date = std::max<double>(ready_date, completion_date->second);
+                    }
+                }
+            }
+            earliest_ready_date = std::min<double>(earliest_ready_date, ready_date);
+        }
+
+        this->tasks.insert(this->tasks.end(), tasks.begin(), tasks.end());
+
+        // The passes before the first one at that date or later can't have started a new task, so they are
+        // the same with or without them
+        unsigned long pass = 0;
+        while ((pass < this->passes.size()) and (this->passes[pass].first < earliest_ready_date)) {
+            pass++;
+        }
+
+        if (pass < this->passes.size()) {
+            // Rewind to that pass: the tasks started in it and after it are scheduled again with the new ones
+            unsigned long num_kept = this->passes[pass].second;
+            this->current_time = this->passes[pass].first;
+            for (unsigned long i = num_kept; i < this->schedule.size(); i++) {
+                tasks.push_back(std::get<0>(this->schedule[i]));
+            }
+            this->schedule.resize(num_kept);
+            this->passes.resize(pass);
+            std::fill(this->idle_date.begin(), this->idle_date.end(), 0.0);
+            for (auto const &started : this->schedule) {
+                this->idle_date[std::get<1>(started)] = this->completion_dates[std::get<0>(started)];
+            }
+        }
+
+        scheduleTasks(tasks, this->idle_date.data(), this->num_hosts, this->core_speed,
+                      this->completion_dates, this->current_time, &this->schedule, &this->passes);
+    }
+
+    /**
+     * @brief Get the makespan of the tasks scheduled so far
+     * @return the makespan
+     */
+    double PartialSchedule::getMakespan() {
+        double makespan = 0.0;
+        for (auto date : this->idle_date) {
+            makespan = std::max<double>(makespan, date);
+        }
+        // completion_dates also has the parents outside of the scheduled tasks
+        return makespan + WorkflowUtil::getStagingTime(this->tasks);
+    }
 
+    unsigned long PartialSchedule::getNumHosts() {
+        return this->num_hosts;
     }
 };
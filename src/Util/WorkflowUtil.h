@@ -13,6 +13,9 @@
 
 
 #include <vector>
+#include <tuple>
+#include <random>
+#include <unordered_map>
 
 namespace wrench {
 
@@ -23,8 +26,81 @@ namespace wrench {
     public:
 
         static double estimateMakespan(std::vector<WorkflowTask*> tasks, unsigned long num_hosts, double core_speed);
+
+        static std::vector<double>
+        estimateMakespans(std::vector<std::tuple<std::vector<WorkflowTask*> *, unsigned long>> configurations,
+                          double core_speed);
         static void printRAM();
 
+        static std::tuple<double, double, double> getMakespanBounds(std::vector<WorkflowTask*> tasks, double core_speed);
+
+        static double getMakespanLowerBound(std::tuple<double, double, double> bounds, unsigned long num_hosts);
+
+        static std::vector<std::vector<unsigned long>> getBatchesByBound(std::vector<double> &bounds,
+                                                                         unsigned long first_batch_size);
+
+        static void setRuntimeModel(const WorkflowTask *task, double nominal_flops, double cv);
+
+        static double getNominalFlops(const WorkflowTask *task);
+
+        static double getRuntimeCV(const WorkflowTask *task);
+
+        static double sampleFlops(double nominal_flops, double cv, std::default_random_engine &rng);
+
+        static std::vector<double>
+        estimateMakespanQuantiles(std::vector<WorkflowTask*> tasks, unsigned long num_hosts, double core_speed,
+                                  std::vector<double> probabilities, unsigned long num_samples = 256);
+
+        static double getWalltimeFactor(std::vector<WorkflowTask*> tasks, unsigned long num_hosts, double core_speed);
+
+        static void addTaskFile(const WorkflowTask *task, std::string file_id, double size, bool is_input);
+
+        static void mergeTaskFiles(const WorkflowTask *merged_task, const WorkflowTask *parent,
+                                   const WorkflowTask *child);
+
+        static std::vector<std::pair<std::string, double>> getInputFiles(const WorkflowTask *task);
+
+        static std::pair<double, double> getStagedBytes(std::vector<WorkflowTask*> tasks);
+
+        static double getStagingTime(std::vector<WorkflowTask*> tasks);
+
+        static std::vector<std::tuple<std::vector<WorkflowTask*>, unsigned long>>
+        getStaggeredAllocations(std::vector<WorkflowTask*> tasks, unsigned long num_hosts, double core_speed,
+                                unsigned long max_num_allocations);
+
+    };
+
+    /**
+     * @brief A makespan estimate that can be extended with more tasks (typically, the next level), which gives
+     *        the same makespan as WorkflowUtil::estimateMakespan() on all the tasks, while only re-scheduling
+     *        the tasks that the new ones can interleave with
+     */
+    class PartialSchedule {
+
+    public:
+
+        PartialSchedule(unsigned long num_hosts, double core_speed);
+
+        void addTasks(std::vector<WorkflowTask*> tasks);
+
+        double getMakespan();
+
+        unsigned long getNumHosts();
+
+    private:
+
+        unsigned long num_hosts;
+        double core_speed;
+        std::vector<double> idle_date;
+        std::unordered_map<WorkflowTask *, double> completion_dates;
+        double current_time;
+        // the (task, host) pairs in the order the tasks are started
+        std::vector<std::tuple<WorkflowTask *, unsigned long>> schedule;
+        // the current date at the start of each pass of the scheduler, and the size of the schedule at that point
+        std::vector<std::pair<double, unsigned long>> passes;
+        // the tasks added so far (whose staging is part of the makespan)
+        std::vector<WorkflowTask *> tasks;
+
     };
 
 };
@@ -14,6 +14,10 @@
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(zhang_wms, "Log category for Zhang WMS");
 
+// Submit the remaining tasks individually if the wait time of one job for all of them is predicted to be
+// larger than this times its runtime (Zhang's ratio, used until individual jobs have been observed in adaptive mode)
+#define INDIVIDUAL_MODE_WAIT_RUN_RATIO 2.0
+
 namespace wrench {
 
     static int sequence = 0;
@@ -24,7 +28,8 @@ namespace wrench {
                        unsigned long max_num_jobs,
                        bool pick_globally_best_split,
                        bool binary_search_for_leeway,
-                       bool calculate_parallelism_based_on_predictions) :
+                       bool calculate_parallelism_based_on_predictions,
+                       bool adaptive_individual_mode) :
             WMS(nullptr, nullptr, {batch_service}, {}, {}, nullptr, hostname, "zhang_wms") {
 
         this->simulator = simulator;
@@ -35,7 +40,12 @@ namespace wrench {
         this->batch_service = batch_service;
         this->pending_placeholder_job = nullptr;
         this->individual_mode = false;
+        this->adaptive_individual_mode = adaptive_individual_mode;
+        this->observed_individual_wait_time = 0;
+        this->observed_individual_runtime = 0;
+        this->last_reconsidered_start_level = ULONG_MAX;
         this->number_of_splits = 0;
+        this->budget = new DecisionBudget(Globals::grouping_budget);
     }
 
     int ZhangWMS::main() {
@@ -51,11 +61,21 @@ namespace wrench {
         this->proxyWMS = new ProxyWMS(this->getWorkflow(), this->job_manager, this->batch_service);
 
         Globals::sim_json["individual_mode"] = false;
+        Globals::sim_json["individual_mode_switches"] = nlohmann::json::array();
         Globals::sim_json["end_levels"] = std::vector<unsigned long> ();
+        Globals::sim_json["budget_truncated"] = std::vector<bool> ();
+        if (Globals::export_pareto_fronts) {
+            Globals::sim_json["pareto_fronts"] = nlohmann::json::array();
+        }
 
         while (not this->getWorkflow()->isDone()) {
             applyGroupingHeuristic();
             this->waitForAndProcessNextEvent();
+            // Process all the events that happened at the same date before acting on them
+            while (this->waitForAndProcessNextEvent(EVENT_COALESCING_TIMEOUT)) {
+                Globals::num_coalesced_events++;
+            }
+            dispatchAllReadyTasks();
         }
 
         assert(this->num_jobs_in_system == 0);
@@ -74,7 +94,13 @@ namespace wrench {
         }
 
         if (this->individual_mode) {
-            return;
+            if (not this->adaptive_individual_mode) {
+                return;
+            }
+            reconsiderIndividualMode();
+            if (this->individual_mode) {
+                return;
+            }
         }
 
         unsigned long start_level = this->proxyWMS->getStartLevel(this->running_placeholder_jobs);
@@ -84,6 +110,9 @@ namespace wrench {
             return;
         }
 
+        this->budget->restart();
+        this->pareto_front.clear();
+
         std::tuple<double, double, double, unsigned long, unsigned long> partial_dag = groupLevels(start_level,
                                                                                                    end_level);
         double partial_dag_wait_time = std::get<0>(partial_dag);
@@ -103,21 +132,19 @@ namespace wrench {
         if (partial_dag_end_level == end_level) {
             // TO PRESERVE THE SAME INDIVIDUAL MODE SWITCHING BEHAVIOR AS ORIGINAL ZHANG
             // calculate the runtime of entire DAG without predictions
-            unsigned long max_parallelism = bestParallelism(start_level, end_level, false);
-            double runtime_all = WorkflowUtil::estimateMakespan(
-                    this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level),
-                    max_parallelism, this->core_speed);
-            double wait_time_all = this->proxyWMS->estimateWaitTime(max_parallelism, runtime_all,
-                                                                    this->simulation->getCurrentSimulatedDate(),
-                                                                    &sequence);
+            std::tuple<double, double> entire_dag = estimateEntireDAG(start_level, end_level);
+            double wait_time_all = std::get<0>(entire_dag);
+            double runtime_all = std::get<1>(entire_dag);
 
             std::cout << "INDIVIDUAL MODE?  WAITTIME = " << wait_time_all << " AND RUNTIME_ALL = "
                       << runtime_all << "\n";
 
-            if (wait_time_all > runtime_all * 2.0) {
+            if (wait_time_all > runtime_all * getIndividualModeThreshold()) {
                 // submit remaining dag as 1 job per task
                 this->individual_mode = true;
+                this->last_reconsidered_start_level = start_level;
                 Globals::sim_json["individual_mode"] = true;
+                recordIndividualModeSwitch(wait_time_all, runtime_all);
                 std::cout << "Switching to individual mode!" << std::endl;
             } else {
                 std::cout << "NOT INDIVIDUAL\n";
@@ -129,6 +156,10 @@ namespace wrench {
 
         // Add the grouping even if we submit as ojpt
         Globals::sim_json["end_levels"].push_back(partial_dag_end_level);
+        Globals::sim_json["budget_truncated"].push_back(this->budget->wasTruncated());
+        if (Globals::export_pareto_fronts) {
+            Globals::sim_json["pareto_fronts"].push_back(this->pareto_front.toJSON());
+        }
 
         if (this->individual_mode) { WRENCH_INFO("Submitting tasks individually after switching to individual mode!");
             this->proxyWMS->submitAllOneJobPerTask(this->core_speed, &(this->num_jobs_in_system), max_num_jobs);
@@ -140,6 +171,82 @@ namespace wrench {
         }
     }
 
+    /**
+     * @brief Estimate the wait time and runtime of one job for all the remaining levels, with as many nodes as
+     *        the widest level (without predictions)
+     * @param start_level: the first remaining level
+     * @param end_level: the last level
+     * @return (wait time, runtime)
+     */
+    std::tuple<double, double> ZhangWMS::estimateEntireDAG(unsigned long start_level, unsigned long end_level) {
+        unsigned long max_parallelism = bestParallelism(start_level, end_level, false);
+        double runtime_all = WorkflowUtil::estimateMakespan(
+                this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level),
+                max_parallelism, this->core_speed);
+        double wait_time_all = this->proxyWMS->estimateWaitTime(max_parallelism, runtime_all,
+                                                                this->simulation->getCurrentSimulatedDate(),
+                                                                &sequence);
+        return std::make_tuple(wait_time_all, runtime_all);
+    }
+
+    /**
+     * @brief Get the wait/run ratio above which one job for all the remaining levels loses to submitting tasks
+     *        individually. Individually, each task of the critical path pays a wait, i.e., the makespan grows by
+     *        about the wait/run ratio of individual jobs, so in adaptive mode that's the ratio observed so far.
+     * @return a wait/run ratio
+     */
+    double ZhangWMS::getIndividualModeThreshold() {
+        if ((not this->adaptive_individual_mode) or (this->observed_individual_runtime <= 0)) {
+            return INDIVIDUAL_MODE_WAIT_RUN_RATIO;
+        }
+        return this->observed_individual_wait_time / this->observed_individual_runtime;
+    }
+
+    /**
+     * @brief In individual mode (adaptive), check at each level boundary whether one job for all the remaining
+     *        levels is now predicted to finish sooner, in which case the remaining levels go back to placeholder jobs.
+     *        This runs after task completions (in applyGroupingHeuristic(), once the completion events at the current
+     *        date have been processed), and only does something when a completion has ended a level
+     */
+    void ZhangWMS::reconsiderIndividualMode() {
+        unsigned long start_level = this->proxyWMS->getStartLevel(this->running_placeholder_jobs);
+        unsigned long end_level = this->getWorkflow()->getNumLevels() - 1;
+        if ((start_level > end_level) or (start_level == this->last_reconsidered_start_level)) {
+            return;
+        }
+        this->last_reconsidered_start_level = start_level;
+
+        std::tuple<double, double> entire_dag = estimateEntireDAG(start_level, end_level);
+        double wait_time_all = std::get<0>(entire_dag);
+        double runtime_all = std::get<1>(entire_dag);
+
+        std::cout << "BACK TO PLACEHOLDER JOBS?  WAITTIME = " << wait_time_all << " AND RUNTIME_ALL = "
+                  << runtime_all << " (THRESHOLD = " << getIndividualModeThreshold() << ")\n";
+
+        if (wait_time_all <= runtime_all * getIndividualModeThreshold()) {
+            this->individual_mode = false;
+            // Tasks that are ready from now on go to placeholder jobs
+            this->proxyWMS->resetReadyTasks();
+            recordIndividualModeSwitch(wait_time_all, runtime_all);
+            std::cout << "Switching back to placeholder jobs at level " << start_level << std::endl;
+        }
+    }
+
+    /**
+     * @brief Add a switch to or from individual mode (the current mode) to the output
+     * @param wait_time_all: the predicted wait time of one job for all the remaining levels
+     * @param runtime_all: the runtime of that job
+     */
+    void ZhangWMS::recordIndividualModeSwitch(double wait_time_all, double runtime_all) {
+        nlohmann::json individual_mode_switch;
+        individual_mode_switch["date"] = this->simulation->getCurrentSimulatedDate();
+        individual_mode_switch["individual_mode"] = this->individual_mode;
+        individual_mode_switch["wait_time"] = wait_time_all;
+        individual_mode_switch["runtime"] = runtime_all;
+        individual_mode_switch["threshold"] = getIndividualModeThreshold();
+        Globals::sim_json["individual_mode_switches"].push_back(individual_mode_switch);
+    }
+
     // return params: (waitt_time, runtime, leeway, end_level, num_nodes)
     std::tuple<double, double, double, unsigned long, unsigned long>
     ZhangWMS::groupLevels(unsigned long start_level, unsigned long end_level) {
@@ -158,14 +265,39 @@ namespace wrench {
         // Start here
         unsigned long candidate_end_level = start_level;
 
+        // The candidate group's schedule, extended one level at a time (and rebuilt when it gets more nodes)
+        PartialSchedule schedule(0, this->core_speed);
+        unsigned long max_parallelism = 0;
+
         while (candidate_end_level <= end_level) {
 
+            // Out of time: stop if there is a grouping, otherwise go straight to the entire DAG
+            bool skipped_levels = false;
+            if ((candidate_end_level < end_level) and this->budget->isExhausted()) {
+                if (best_end_level != ULONG_MAX) {
+                    break;
+                }
+                for (unsigned long l = candidate_end_level; l < end_level; l++) {
+                    max_parallelism = std::max<unsigned long>(
+                            max_parallelism, this->getWorkflow()->getTasksInTopLevelRange(l, l).size());
+                }
+                candidate_end_level = end_level;
+                skipped_levels = true;
+            }
+
             std::cout << "Candidate end level: " << candidate_end_level << std::endl;
 
-            unsigned long num_nodes = bestParallelism(start_level, candidate_end_level, false);
-            double runtime = WorkflowUtil::estimateMakespan(
-                    this->getWorkflow()->getTasksInTopLevelRange(start_level, candidate_end_level),
-                    num_nodes, this->core_speed);
+            std::vector<WorkflowTask *> tasks_in_level =
+                    this->getWorkflow()->getTasksInTopLevelRange(candidate_end_level, candidate_end_level);
+            max_parallelism = std::max<unsigned long>(max_parallelism, tasks_in_level.size());
+            unsigned long num_nodes = std::min<unsigned long>(max_parallelism, this->number_of_hosts);
+            if (skipped_levels or (num_nodes != schedule.getNumHosts())) {
+                schedule = PartialSchedule(num_nodes, this->core_speed);
+                schedule.addTasks(this->getWorkflow()->getTasksInTopLevelRange(start_level, candidate_end_level));
+            } else {
+                schedule.addTasks(tasks_in_level);
+            }
+            double runtime = schedule.getMakespan();
             double wait_time = this->proxyWMS->estimateWaitTime(num_nodes, runtime,
                                                                 this->simulation->getCurrentSimulatedDate(),
                                                                 &sequence);
@@ -250,24 +382,97 @@ namespace wrench {
 
         double parent_runtime = this->proxyWMS->findMaxDuration(this->running_placeholder_jobs);
 
+        // With a budget, look at the numbers of nodes from coarse to fine, otherwise all at once
+        std::vector<std::vector<unsigned long>> rounds;
+        if (this->budget->isLimited()) {
+            rounds = DecisionBudget::coarseToFine(1, max_parallelism);
+        } else {
+            rounds.push_back({});
+            for (unsigned long i = 1; i < max_parallelism + 1; i++) {
+                rounds[0].push_back(i);
+            }
+        }
+
+        std::vector<WorkflowTask *> tasks = this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level);
+        std::tuple<double, double, double> makespan_bounds = WorkflowUtil::getMakespanBounds(tasks, this->core_speed);
+
+        // Candidates are ranked in the order they are listed, and the first one wins ties. Those that can't
+        // beat the best one (the wait time is at least the parent runtime) are skipped, unless they may be
+        // on the Pareto front.
         unsigned long best_parallelism = 0;
+        unsigned long best_rank = ULONG_MAX;
         double best_total_time = DBL_MAX;
-        for (unsigned long i = 1; i < max_parallelism + 1; i++) {
-            double makespan = WorkflowUtil::estimateMakespan(
-                    this->getWorkflow()->getTasksInTopLevelRange(start_level, end_level),
-                    i, this->core_speed);
-            double wait_time = this->proxyWMS->estimateWaitTime(i, makespan,
-                                                                this->simulation->getCurrentSimulatedDate(), &sequence);
+        bool prune = not ParetoFront::isEnabled();
+        this->pareto_front.clear();
+        auto cannot_win = [prune, &best_rank, &best_total_time](double bound, unsigned long rank) -> bool {
+            return prune and (best_rank != ULONG_MAX) and
+                   ((bound > best_total_time) or ((bound == best_total_time) and (rank > best_rank)));
+        };
+
+        unsigned long first_rank = 0;
+        for (auto const &round : rounds) {
+            if ((best_parallelism != 0) and this->budget->isExhausted()) {
+                break;
+            }
 
-            if (wait_time < parent_runtime) { // We don't care if your wait time is smaller than the parent runtime!
-                wait_time = parent_runtime;
+            std::vector<double> bounds;
+            for (auto i : round) {
+                bounds.push_back(WorkflowUtil::getMakespanLowerBound(makespan_bounds, i) + parent_runtime);
             }
 
-            double total_time = makespan + wait_time;
-            if (total_time < best_total_time) {
-                best_total_time = total_time;
-                best_parallelism = i;
+            // Compute the makespans of the most promising candidates in parallel, then get their wait times at once
+            for (auto const &batch : WorkflowUtil::getBatchesByBound(bounds, Globals::num_threads)) {
+                std::vector<unsigned long> batch_candidates;
+                std::vector<std::tuple<std::vector<WorkflowTask *> *, unsigned long>> configurations;
+                for (auto c : batch) {
+                    if (cannot_win(bounds[c], first_rank + c)) {
+                        Globals::num_pruned_makespan_estimates++;
+                        continue;
+                    }
+                    batch_candidates.push_back(c);
+                    configurations.push_back(std::make_tuple(&tasks, round[c]));
+                }
+                std::vector<double> makespans = WorkflowUtil::estimateMakespans(configurations, this->core_speed);
+
+                std::vector<unsigned long> candidates;
+                std::vector<double> candidate_makespans;
+                std::vector<std::tuple<unsigned long, double>> job_configurations;
+                for (unsigned long b = 0; b < batch_candidates.size(); b++) {
+                    unsigned long c = batch_candidates[b];
+                    if (cannot_win(makespans[b] + parent_runtime, first_rank + c)) {
+                        Globals::num_pruned_wait_time_estimates++;
+                        continue;
+                    }
+                    candidates.push_back(c);
+                    candidate_makespans.push_back(makespans[b]);
+                    job_configurations.push_back(std::make_tuple(round[c], makespans[b]));
+                }
+                std::vector<double> wait_times = this->proxyWMS->estimateWaitTimes(
+                        job_configurations, this->simulation->getCurrentSimulatedDate(), &sequence);
+
+                for (unsigned long k = 0; k < candidates.size(); k++) {
+                    unsigned long rank = first_rank + candidates[k];
+                    double makespan = candidate_makespans[k];
+                    double wait_time = wait_times[k];
+
+                    if (wait_time < parent_runtime) { // We don't care if your wait time is smaller than the parent runtime!
+                        wait_time = parent_runtime;
+                    }
+
+                    double total_time = makespan + wait_time;
+                    this->pareto_front.add(round[candidates[k]], total_time, round[candidates[k]] * makespan);
+                    if ((total_time < best_total_time) or ((total_time == best_total_time) and (rank < best_rank))) {
+                        best_total_time = total_time;
+                        best_parallelism = round[candidates[k]];
+                        best_rank = rank;
+                    }
+                }
             }
+            first_rank += round.size();
+        }
+
+        if (ParetoFront::isUsedForChoice() and (best_parallelism != 0)) {
+            best_parallelism = this->pareto_front.pick(Globals::pareto_weight);
         }
 
         return best_parallelism;
@@ -355,22 +560,8 @@ namespace wrench {
         this->running_placeholder_jobs.insert(placeholder_job);
         this->pending_placeholder_job = nullptr;
 
-        // std::string output_string = "";
-
-        for (auto task : placeholder_job->tasks) {
-            if (task->getState() == WorkflowTask::State::READY  and (placeholder_job->num_standard_job_submitted < placeholder_job->num_hosts)) {
-                auto standard_job = this->job_manager->createStandardJob(task, {});
-
-                // output_string += " " + task->getID();
-
-                WRENCH_INFO("Submitting task %s as part of placeholder job %ld-%ld",
-                            task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
-                placeholder_job->num_standard_job_submitted++;
-            }
-        }
-
-        this->applyGroupingHeuristic();
+        placeholder_job->start_date = this->simulation->getCurrentSimulatedDate();
+        placeholder_job->initializeReadyTasks();
     }
 
     void ZhangWMS::processEventPilotJobExpiration(std::shared_ptr<PilotJobExpiredEvent> e) {
@@ -395,13 +586,7 @@ namespace wrench {
                     placeholder_job->pilot_job->getName().c_str());
 
         // Check if there are unprocessed tasks
-        bool unprocessed = false;
-        for (auto t : placeholder_job->tasks) {
-            if (t->getState() != WorkflowTask::COMPLETED) {
-                unprocessed = true;
-                break;
-            }
-        }
+        bool unprocessed = placeholder_job->hasUnprocessedTasks();
 
         unsigned long num_used_nodes;
         sscanf(e->pilot_job->getServiceSpecificArguments()["-N"].c_str(), "%lu", &num_used_nodes);
@@ -411,13 +596,24 @@ namespace wrench {
 
         double wasted_node_seconds = 60.0 * num_used_minutes * num_used_nodes;
 
-        for (auto t : placeholder_job->tasks) {
+        for (auto t : placeholder_job->getExecutedTasks()) {
             if (t->getState() == WorkflowTask::State::COMPLETED) {
                 wasted_node_seconds -= t->getFlops() / this->core_speed;
             }
         }
         this->simulator->wasted_node_seconds += wasted_node_seconds;
 
+        // The tasks it took from other placeholder jobs and didn't complete go back to them
+        std::vector<WorkflowTask *> stolen_tasks_to_return;
+        for (auto const &stolen_task : placeholder_job->stolen_tasks) {
+            if (stolen_task.first->getState() != WorkflowTask::State::COMPLETED) {
+                stolen_tasks_to_return.push_back(stolen_task.first);
+            }
+        }
+        for (auto t : stolen_tasks_to_return) {
+            placeholder_job->returnStolenTask(t);
+        }
+
         if (not unprocessed) {
             // Nothing to do
             WRENCH_INFO("This placeholder job has no unprocessed tasks. great.");
@@ -428,6 +624,9 @@ namespace wrench {
 
         WRENCH_INFO("This placeholder job has unprocessed tasks");
 
+        // Its unprocessed tasks become ready again without any completion to announce it
+        this->proxyWMS->resetReadyTasks();
+
         if (this->pending_placeholder_job) {
             // Cancel pending pilot job if any
             WRENCH_INFO("Canceling pending placeholder job (placeholder=%ld,  pilot_job=%ld / %s",
@@ -465,8 +664,6 @@ namespace wrench {
         for (auto ph : to_remove) {
             this->running_placeholder_jobs.erase(ph);
         }
-
-        this->applyGroupingHeuristic();
     }
 
     void ZhangWMS::processEventStandardJobCompletion(std::shared_ptr<StandardJobCompletedEvent> e) {
@@ -480,103 +677,101 @@ namespace wrench {
 
         this->simulator->used_node_seconds += completed_task->getFlops() / this->core_speed;
 
-        // Find the placeholder job this task belongs to
+        // Find the running placeholder job this task belongs to, and the one it ran in if it was stolen
         PlaceHolderJob *placeholder_job = nullptr;
+        PlaceHolderJob *host_placeholder_job = nullptr;
         for (auto ph : this->running_placeholder_jobs) {
-            for (auto task : ph->tasks) {
-                if (task == completed_task) {
-                    placeholder_job = ph;
-                    break;
-                }
+            if (ph->hasTask(completed_task)) {
+                placeholder_job = ph;
+            }
+            if (ph->stolen_tasks.find(completed_task) != ph->stolen_tasks.end()) {
+                host_placeholder_job = ph;
             }
         }
 
-        if ((placeholder_job == nullptr) and (not this->individual_mode)) {
+        // (placeholder jobs may also have tasks that were submitted individually)
+        bool individual_job = this->proxyWMS->isIndividualJob(e->standard_job.get());
+
+        if ((placeholder_job == nullptr) and (host_placeholder_job == nullptr) and (not individual_job)) {
             throw std::runtime_error("Got a task completion, but couldn't find a placeholder for the task, "
                                      "and we're not in individual mode");
         }
 
-        if ((placeholder_job ==  nullptr) and (this->individual_mode)) {
-            this->num_jobs_in_system--;
+        if (individual_job) {
+            this->observed_individual_wait_time += completed_task->getStartDate() - e->standard_job->getSubmitDate();
+            this->observed_individual_runtime += completed_task->getFlops() / this->core_speed;
+            if (this->proxyWMS->completeIndividualJob(e->standard_job.get())) {
+                this->num_jobs_in_system--;
+            }
+        } else if (host_placeholder_job != nullptr) {
+            host_placeholder_job->num_standard_job_submitted--;
+        } else if (placeholder_job != nullptr) {
+            placeholder_job->num_standard_job_submitted--;
         }
-
         if (placeholder_job != nullptr) {
+            placeholder_job->markTaskCompleted(completed_task);
+        }
 
-            placeholder_job->num_standard_job_submitted--;
-
-            // Terminate the pilot job in case all its tasks are done
-            bool all_tasks_done = true;
-            for (auto t : placeholder_job->tasks) {
-                if (t->getState() != WorkflowTask::COMPLETED) {
-                    all_tasks_done = false;
-                    break;
-                }
-            }
-            if (all_tasks_done) {
-                // Update the wasted no seconds metric
-                double first_task_start_time = DBL_MAX;
-                for (auto const &t : placeholder_job->tasks) {
-                    if (t->getStartDate() < first_task_start_time) {
-                        first_task_start_time = t->getStartDate();
-                    }
-                }
-                int num_requested_nodes = stoi(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"]);
-                double job_duration = this->simulation->getCurrentSimulatedDate() - first_task_start_time;
-                double wasted_node_seconds = num_requested_nodes * job_duration;
-                for (auto const &t : placeholder_job->tasks) {
-                    wasted_node_seconds -= t->getFlops() / this->core_speed;
-                }
-
-                this->simulator->wasted_node_seconds += wasted_node_seconds;
-
-                WRENCH_INFO("All tasks are completed in this placeholder job, so I am terminating it (%s)",
-                            placeholder_job->pilot_job->getName().c_str());
+        // Cancel the pending pilot job if all its tasks were run by others
+        if ((this->pending_placeholder_job != nullptr) and this->pending_placeholder_job->hasTask(completed_task)) {
+            this->pending_placeholder_job->markTaskCompleted(completed_task);
+            if (this->pending_placeholder_job->areAllTasksCompleted()) {
+                WRENCH_INFO("All tasks of the pending placeholder job were run by others, so I am canceling it (%s)",
+                            this->pending_placeholder_job->pilot_job->getName().c_str());
                 try {
-                    // hmm
-                    WRENCH_INFO("TERMINATING A PILOT JOB");
-                    this->job_manager->terminateJob(placeholder_job->pilot_job);
+                    this->job_manager->terminateJob(this->pending_placeholder_job->pilot_job);
                 } catch (WorkflowExecutionException &e) {
                     // ignore
                 }
-                this->running_placeholder_jobs.erase(placeholder_job);
+                this->pending_placeholder_job = nullptr;
                 this->num_jobs_in_system--;
             }
         }
 
-        // Start all newly ready tasks that depended on the completed task, IN ANY PLACEHOLDER
-        std::vector<WorkflowTask *> children = this->getWorkflow()->getTaskChildren(completed_task);
-        for (auto ph : this->running_placeholder_jobs) {
-
-            // Start Other tasks if possible, considering first tasks at the same level of completed_task
-            for (auto task : ph->tasks) {
-                if ((task->getState() == WorkflowTask::READY) and
-                    (task->getTopLevel() == completed_task->getTopLevel()) and
-                    (ph->num_standard_job_submitted < ph->num_hosts)) {
-
-                    auto standard_job = this->job_manager->createStandardJob(task, {});
-                    // hmm
-                    WRENCH_INFO("Submitting task %s  as part of placeholder job %ld-%ld",
-                                task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                    this->job_manager->submitJob(standard_job, ph->pilot_job->getComputeService());
-
-                    ph->num_standard_job_submitted++;
+        // Terminate the pilot jobs in case all their tasks are done
+        for (auto ph : {placeholder_job, host_placeholder_job}) {
+            if ((ph != nullptr) and (this->running_placeholder_jobs.find(ph) != this->running_placeholder_jobs.end()) and
+                ph->isDone()) {
+                terminatePlaceholderJob(ph);
+            }
+        }
 
+        // Queue the children that this completion made ready in their placeholder, IN ANY PLACEHOLDER
+        // (including the pending one, whose ready tasks running placeholder jobs can take)
+        for (auto child : this->getWorkflow()->getTaskChildren(completed_task)) {
+            if (child->getState() != WorkflowTask::READY) {
+                continue;
+            }
+            if ((this->pending_placeholder_job != nullptr) and this->pending_placeholder_job->hasTask(child)) {
+                this->pending_placeholder_job->enqueueReadyTask(child);
+                continue;
+            }
+            for (auto ph : this->running_placeholder_jobs) {
+                if (ph->hasTask(child)) {
+                    ph->enqueueReadyTask(child);
+                    break;
                 }
             }
+        }
 
-            // Start Any other READY TASKS if possible
-            for (auto task : ph->tasks) {
-                if ((task->getState() == WorkflowTask::READY) and (ph->num_standard_job_submitted < ph->num_hosts)) {
-
-                    auto standard_job = this->job_manager->createStandardJob(task, {});
-                    // hmm
-                    WRENCH_INFO("Submitting task %s  as part of placeholder job %ld-%ld",
-                                task->getID().c_str(), placeholder_job->start_level, placeholder_job->end_level);
-                    this->job_manager->submitJob(standard_job, ph->pilot_job->getComputeService());
+        if (this->individual_mode) {
+            this->proxyWMS->enqueueReadyChildren(completed_task);
+        }
+    }
 
-                    ph->num_standard_job_submitted++;
+    /**
+     * @brief Submit the ready tasks of all running placeholder jobs (and, in individual mode, the other
+     *        ready tasks), once all the events at the current date have been processed
+     */
+    void ZhangWMS::dispatchAllReadyTasks() {
+        for (auto ph : this->running_placeholder_jobs) {
+            this->proxyWMS->dispatchReadyTasks(ph);
+        }
 
-                }
+        // Hosts that are still idle can run the next group's tasks
+        if (Globals::work_stealing and (this->pending_placeholder_job != nullptr)) {
+            for (auto ph : this->running_placeholder_jobs) {
+                this->dispatchStolenTasks(ph, this->pending_placeholder_job);
             }
         }
 
@@ -586,9 +781,78 @@ namespace wrench {
         }
     }
 
+    /**
+     * @brief Terminate a running placeholder job whose tasks are all done, and account for its wasted node time
+     * @param placeholder_job: a running placeholder job
+     */
+    void ZhangWMS::terminatePlaceholderJob(PlaceHolderJob *placeholder_job) {
+        // Update the wasted no seconds metric
+        double first_task_start_time = DBL_MAX;
+        for (auto const &t : placeholder_job->getExecutedTasks()) {
+            if (t->getStartDate() < first_task_start_time) {
+                first_task_start_time = t->getStartDate();
+            }
+        }
+        int num_requested_nodes = stoi(placeholder_job->pilot_job->getServiceSpecificArguments()["-N"]);
+        double job_duration = this->simulation->getCurrentSimulatedDate() - first_task_start_time;
+        double wasted_node_seconds = num_requested_nodes * job_duration;
+        for (auto const &t : placeholder_job->getExecutedTasks()) {
+            wasted_node_seconds -= t->getFlops() / this->core_speed;
+        }
+
+        this->simulator->wasted_node_seconds += wasted_node_seconds;
+
+        WRENCH_INFO("All tasks are completed in this placeholder job, so I am terminating it (%s)",
+                    placeholder_job->pilot_job->getName().c_str());
+        try {
+            // hmm
+            WRENCH_INFO("TERMINATING A PILOT JOB");
+            this->job_manager->terminateJob(placeholder_job->pilot_job);
+        } catch (WorkflowExecutionException &e) {
+            // ignore
+        }
+        this->running_placeholder_jobs.erase(placeholder_job);
+        this->num_jobs_in_system--;
+    }
+
+    /**
+     * @brief Submit ready tasks of another placeholder job to the idle hosts of a running placeholder job
+     * @param placeholder_job: a running placeholder job
+     * @param victim: the placeholder job to take tasks from
+     */
+    void ZhangWMS::dispatchStolenTasks(PlaceHolderJob *placeholder_job, PlaceHolderJob *victim) {
+        while (placeholder_job->num_standard_job_submitted < placeholder_job->num_hosts) {
+            WorkflowTask *task = placeholder_job->stealReadyTask(victim, this->simulation->getCurrentSimulatedDate(),
+                                                                 this->core_speed);
+            if (task == nullptr) {
+                break;
+            }
+
+            auto standard_job = this->job_manager->createStandardJob(task, {});
+            WRENCH_INFO("Submitting task %s of placeholder job %ld-%ld as part of placeholder job %ld-%ld",
+                        task->getID().c_str(), victim->start_level, victim->end_level,
+                        placeholder_job->start_level, placeholder_job->end_level);
+            this->job_manager->submitJob(standard_job, placeholder_job->pilot_job->getComputeService());
+            placeholder_job->num_standard_job_submitted++;
+        }
+    }
+
     void ZhangWMS::processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> e) {
+        WorkflowTask *failed_task = e->standard_job->tasks[0];
+
+        // A stolen task that couldn't complete goes back to the placeholder job it belongs to
+        for (auto ph : this->running_placeholder_jobs) {
+            PlaceHolderJob *owner = ph->returnStolenTask(failed_task);
+            if (owner != nullptr) {
+                ph->num_standard_job_submitted--;
+                WRENCH_INFO("Stolen task %s failed, giving it back to placeholder job %ld-%ld",
+                            failed_task->getID().c_str(), owner->start_level, owner->end_level);
+                return;
+            }
+        }
+
         WRENCH_INFO("Got a standard job failure event for task %s -- IGNORING THIS",
-                    e->standard_job->tasks[0]->getID().c_str());
+                    failed_task->getID().c_str());
         throw std::runtime_error("A job has failed, which shouldn't happen");
     }
 
@@ -14,6 +14,8 @@
 #include "Simulator.h"
 #include <Util/PlaceHolderJob.h>
 #include <Util/ProxyWMS.h>
+#include <Util/DecisionBudget.h>
+#include <Util/ParetoFront.h>
 
 namespace wrench {
 
@@ -27,7 +29,8 @@ namespace wrench {
                  unsigned long max_num_jobs,
                  bool pick_globally_best_split,
                  bool binary_search_for_leeway,
-                 bool calculate_parallelism_based_on_predictions);
+                 bool calculate_parallelism_based_on_predictions,
+                 bool adaptive_individual_mode = false);
 
     private:
 
@@ -48,6 +51,14 @@ namespace wrench {
 
         unsigned long bestParallelism(unsigned long start_level, unsigned long end_level, bool use_predictions);
 
+        std::tuple<double, double> estimateEntireDAG(unsigned long start_level, unsigned long end_level);
+
+        double getIndividualModeThreshold();
+
+        void reconsiderIndividualMode();
+
+        void recordIndividualModeSwitch(double wait_time_all, double runtime_all);
+
         double calculateLeeway(double wait_time, double runtime, unsigned long num_nodes);
 
         double calculateLeewayBinarySearch(double runtime, unsigned long num_nodes, double parent_runtime, double lower,
@@ -64,10 +75,23 @@ namespace wrench {
 
         void processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent> e) override;
 
+        void dispatchAllReadyTasks();
+
+        void dispatchStolenTasks(PlaceHolderJob *placeholder_job, PlaceHolderJob *victim);
+
+        void terminatePlaceholderJob(PlaceHolderJob *placeholder_job);
+
         // std::tuple<double, double, unsigned long, unsigned long> groupLevels(unsigned long start_level, unsigned long end_level);
 
         bool individual_mode;
 
+        // Whether the switch to individual mode is calibrated with the wait/run ratios of individual jobs, and
+        // reconsidered at each level boundary (i.e., when a task completion ends a level)
+        bool adaptive_individual_mode;
+        double observed_individual_wait_time;
+        double observed_individual_runtime;
+        unsigned long last_reconsidered_start_level;
+
         PlaceHolderJob *pending_placeholder_job;
         std::set<PlaceHolderJob *> running_placeholder_jobs;
         double core_speed;
@@ -81,6 +105,11 @@ namespace wrench {
         // Number of times the workflow was split
         unsigned long number_of_splits;
 
+        DecisionBudget *budget;
+
+        // Candidates of the current decision's number-of-nodes choice (empty without predictions)
+        ParetoFront pareto_front;
+
     };
 
 }
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2019. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/**
+ * Compares the vectorized host scans (SSE4.1, AVX2, AVX-512) with the scalar ones, which must give exactly the
+ * same results, on random inputs and on edge cases: ties, lengths that don't fill a vector, and lengths 0 and 1.
+ * The instruction sets that the CPU doesn't support are skipped.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Util/HostScans.h>
+
+using namespace wrench;
+
+static unsigned long num_checks = 0;
+static unsigned long num_failures = 0;
+
+template<typename T>
+static void check(const std::string &instruction_set, const std::string &scan, const std::string &input,
+                  unsigned long num_values, T expected, T actual) {
+    num_checks++;
+    if (expected != actual) {
+        num_failures++;
+        std::cerr << "FAILED: " << instruction_set << " " << scan << " on " << input << " (" << num_values
+                  << " values): expected " << expected << ", got " << actual << "\n";
+    }
+}
+
+/**
+ * @brief Compare all the scans of an instruction set with the scalar ones on some values
+ * @param instruction_set: the instruction set
+ * @param kernels: its kernels
+ * @param scalar: the scalar kernels
+ * @param input: the name of the input, for the error messages
+ * @param values: the values (exactly sized, so that reading past them can be caught by sanitizers)
+ * @param thresholds: the thresholds to try
+ */
+static void compareScans(const std::string &instruction_set, const HostScans::Kernels &kernels,
+                         const HostScans::Kernels &scalar, const std::string &input,
+                         const std::vector<double> &values, const std::vector<double> &thresholds) {
+    unsigned long n = values.size();
+    // nullptr for length 0, so that any access fails
+    const double *data = (n == 0 ? nullptr : values.data());
+
+    // getMin() and getMax() require at least one value
+    if (n > 0) {
+        check(instruction_set, "getMin", input, n, scalar.get_min(data, n), kernels.get_min(data, n));
+        check(instruction_set, "getMax", input, n, scalar.get_max(data, n), kernels.get_max(data, n));
+    }
+    for (auto threshold : thresholds) {
+        check(instruction_set, "getMinAbove", input, n, scalar.get_min_above(data, n, threshold),
+              kernels.get_min_above(data, n, threshold));
+        check(instruction_set, "findFirstAtMost", input, n, scalar.find_first_at_most(data, n, threshold),
+              kernels.find_first_at_most(data, n, threshold));
+    }
+}
+
+/**
+ * @brief Get thresholds that hit the edge cases of the scans with some values: each value (ties with the
+ *        threshold), values in between, and thresholds below and above all values
+ * @param values: the values
+ * @return the thresholds
+ */
+static std::vector<double> getThresholds(const std::vector<double> &values) {
+    std::vector<double> thresholds = {-DBL_MAX, -1.0, 0.0, 0.5, DBL_MAX};
+    for (auto value : values) {
+        thresholds.push_back(value);
+        thresholds.push_back(value + 0.25);
+    }
+    return thresholds;
+}
+
+int main(int argc, char **argv) {
+
+    HostScans::Kernels scalar;
+    HostScans::getKernels("scalar", scalar);
+
+    // Sanity check of the scalar scans themselves
+    std::vector<double> known = {3.0, 1.0, 4.0, 1.0, 5.0};
+    check("scalar", "getMin", "known values", known.size(), 1.0, scalar.get_min(known.data(), known.size()));
+    check("scalar", "getMax", "known values", known.size(), 5.0, scalar.get_max(known.data(), known.size()));
+    check("scalar", "getMinAbove", "known values", known.size(), 3.0,
+          scalar.get_min_above(known.data(), known.size(), 1.0));
+    check("scalar", "getMinAbove", "known values", known.size(), DBL_MAX,
+          scalar.get_min_above(known.data(), known.size(), 5.0));
+    check("scalar", "findFirstAtMost", "known values", known.size(), 1UL,
+          scalar.find_first_at_most(known.data(), known.size(), 1.0));
+    check("scalar", "findFirstAtMost", "known values", known.size(), known.size(),
+          scalar.find_first_at_most(known.data(), known.size(), 0.5));
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> random_date(0.0, 1000.0);
+    std::uniform_int_distribution<int> random_tie(0, 3);
+
+    for (auto instruction_set : {"sse4.1", "avx2", "avx512"}) {
+        HostScans::Kernels kernels;
+        if (not HostScans::getKernels(instruction_set, kernels)) {
+            std::cout << instruction_set << ": not supported, skipped\n";
+            continue;
+        }
+        unsigned long num_checks_before = num_checks;
+
+        // Every length up to a few vectors of the widest instruction set, so that all the leftover
+        // counts are covered, then a few larger ones
+        std::vector<unsigned long> lengths;
+        for (unsigned long n = 0; n <= 35; n++) {
+            lengths.push_back(n);
+        }
+        for (unsigned long n : {63UL, 64UL, 65UL, 127UL, 1000UL, 1001UL}) {
+            lengths.push_back(n);
+        }
+
+        for (auto n : lengths) {
+            std::vector<double> values(n);
+
+            // Random dates
+            for (auto &v : values) {
+                v = random_date(rng);
+            }
+            compareScans(instruction_set, kernels, scalar, "random values", values, getThresholds(values));
+
+            // Few distinct values, so that the minimum, the maximum and the thresholds are tied many times
+            for (auto &v : values) {
+                v = (double) random_tie(rng);
+            }
+            compareScans(instruction_set, kernels, scalar, "tied values", values, getThresholds(values));
+
+            // All equal (e.g., all hosts idle at 0)
+            std::fill(values.begin(), values.end(), 0.0);
+            compareScans(instruction_set, kernels, scalar, "equal values", values, getThresholds(values));
+
+            // Increasing and decreasing, so that the extremes are at either end
+            for (unsigned long i = 0; i < n; i++) {
+                values[i] = (double) i;
+            }
+            compareScans(instruction_set, kernels, scalar, "increasing values", values, getThresholds(values));
+            std::reverse(values.begin(), values.end());
+            compareScans(instruction_set, kernels, scalar, "decreasing values", values, getThresholds(values));
+
+            // DBL_MAX values, which getMinAbove() uses for the values it skips
+            for (unsigned long i = 0; i < n; i++) {
+                values[i] = (i % 3 == 0 ? DBL_MAX : random_date(rng));
+            }
+            compareScans(instruction_set, kernels, scalar, "values with DBL_MAX", values, getThresholds(values));
+        }
+
+        std::cout << instruction_set << ": " << (num_checks - num_checks_before) << " checks\n";
+    }
+
+    if (num_failures > 0) {
+        std::cerr << num_failures << " of " << num_checks << " checks failed\n";
+        return 1;
+    }
+    std::cout << "All " << num_checks << " checks passed\n";
+    return 0;
+}